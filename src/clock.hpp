@@ -0,0 +1,49 @@
+#pragma once
+
+#include <cstdint>
+
+#include "network_types.hpp"
+
+namespace iac {
+
+// source of the timestamps of a local node
+class Clock {
+   public:
+    virtual ~Clock() = default;
+
+    virtual timestamp now() const = 0;
+};
+
+// monotonic clock with microsecond resolution, used by nodes without another clock
+class SteadyClock : public Clock {
+   public:
+    timestamp now() const override {
+        return timestamp::now();
+    };
+};
+
+// clock which only moves when it is advanced, so simulations run as fast as possible and
+// timeouts happen at the same point of every run
+class VirtualClock : public Clock {
+   public:
+    // NOTE: 0 marks timestamps which were never set, so virtual time starts later
+    explicit VirtualClock(timestamp start = timestamp::from_ms(1))
+        : m_now(start){};
+
+    timestamp now() const override {
+        return m_now;
+    };
+
+    void advance_us(uint64_t us) {
+        m_now.ts += us;
+    };
+
+    void advance_ms(uint64_t ms) {
+        advance_us(ms * 1000);
+    };
+
+   private:
+    timestamp m_now;
+};
+
+}  // namespace iac
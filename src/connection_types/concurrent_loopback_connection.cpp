@@ -0,0 +1,61 @@
+#ifndef ARDUINO
+
+#    include "concurrent_loopback_connection.hpp"
+
+namespace iac {
+
+ConcurrentLoopbackConnection::ConcurrentLoopbackConnection(queue_t* write_queue, queue_t* read_queue)
+    : m_write_queue(write_queue), m_read_queue(read_queue) {}
+
+size_t ConcurrentLoopbackConnection::read(void* buffer, size_t size) {
+    size_t read_size = read_put_back_queue(buffer, size);
+    return read_size + m_read_queue->pop(buffer, size);
+}
+
+size_t ConcurrentLoopbackConnection::write(const void* buffer, size_t size) {
+    return m_write_queue->push(buffer, size) ? size : 0;
+}
+
+size_t ConcurrentLoopbackConnection::write_vectored(const io_vector_t* vectors, size_t count) {
+    size_t total_size = 0;
+    for (size_t i = 0; i < count; i++)
+        total_size += vectors[i].size;
+
+    if (total_size > m_write_queue->free_space()) return 0;
+
+    // NOTE: there is only one producer, so the checked space can't shrink in between
+    for (size_t i = 0; i < count; i++)
+        m_write_queue->push(vectors[i].buffer, vectors[i].size);
+
+    return total_size;
+}
+
+bool ConcurrentLoopbackConnection::flush() {
+    return true;
+}
+
+bool ConcurrentLoopbackConnection::clear() {
+    clear_put_back_queue();
+    m_read_queue->consume(m_read_queue->size());
+    return true;
+}
+
+size_t ConcurrentLoopbackConnection::available() {
+    return m_read_queue->size() + available_put_back_queue();
+}
+
+size_t ConcurrentLoopbackConnection::buffered() const {
+    return m_read_queue->size() + Connection::buffered();
+}
+
+bool ConcurrentLoopbackConnection::open() {
+    return true;
+}
+
+bool ConcurrentLoopbackConnection::close() {
+    return true;
+}
+
+}  // namespace iac
+
+#endif
@@ -0,0 +1,40 @@
+#pragma once
+
+#ifndef ARDUINO
+
+#    include "../spsc_ring_buffer.hpp"
+#    include "connection.hpp"
+
+namespace iac {
+
+// loopback between two nodes which are updated from different threads,
+// each queue has exactly one writing and one reading node
+class ConcurrentLoopbackConnection : public Connection {
+   public:
+    typedef OwnedSpscRingBuffer queue_t;
+
+    ConcurrentLoopbackConnection(queue_t* write_queue, queue_t* read_queue);
+
+    size_t read(void* buffer, size_t size) override;
+    // NOTE: writes are all or nothing, a full queue would otherwise leave a partial package behind
+    size_t write(const void* buffer, size_t size) override;
+    size_t write_vectored(const io_vector_t* vectors, size_t count) override;
+
+    bool flush() override;
+    bool clear() override;
+
+    size_t available() override;
+
+    size_t buffered() const override;
+
+    bool open() override;
+    bool close() override;
+
+   private:
+    queue_t* m_write_queue = nullptr;
+    queue_t* m_read_queue = nullptr;
+};
+
+}  // namespace iac
+
+#endif
@@ -2,24 +2,56 @@
 
 namespace iac {
 
+size_t Connection::write_vectored(const io_vector_t* vectors, size_t count) {
+    size_t written_size = 0;
+
+    for (size_t i = 0; i < count; i++) {
+        size_t vector_written_size = write(vectors[i].buffer, vectors[i].size);
+        written_size += vector_written_size;
+
+        if (vector_written_size != vectors[i].size) break;
+    }
+
+    return written_size;
+}
+
 void Connection::put_back(const void* buffer, size_t size) {
-    auto* cursor = (uint8_t*)buffer;
+    m_put_back_queue.push(buffer, size);
+}
+
+size_t Connection::peek(void* buffer, size_t size) {
+    if (m_put_back_queue.size() >= size)
+        return m_put_back_queue.peek(buffer, size);
+
+    // NOTE: read() serves the put-back queue first, so it is drained completely
+    //       and refilled with all peeked bytes in order
+    size_t read_size = read(buffer, size);
+    m_put_back_queue.push(buffer, read_size);
 
-    for (size_t i = 0; i < size; i++) {
-        m_put_back_queue.push(*cursor++);
+    return read_size;
+}
+
+size_t Connection::consume(size_t size) {
+    size_t consumed_size = m_put_back_queue.consume(size);
+
+    static constexpr size_t scratch_buffer_size = 64;
+    uint8_t scratch_buffer[scratch_buffer_size];
+
+    while (consumed_size < size) {
+        size_t read_size = read(scratch_buffer, min_of(size - consumed_size, scratch_buffer_size));
+        if (read_size == 0) break;
+
+        consumed_size += read_size;
     }
+
+    return consumed_size;
 }
 
 size_t Connection::read_put_back_queue(void*& buffer, size_t& size) {
-    auto& cursor = (uint8_t*&)buffer;
-    size_t read_size = 0;
-
-    while (!m_put_back_queue.empty() && size > 0) {
-        *cursor++ = m_put_back_queue.front();
-        m_put_back_queue.pop();
-        size--;
-        read_size++;
-    }
+    size_t read_size = m_put_back_queue.pop(buffer, size);
+
+    buffer = (uint8_t*)buffer + read_size;
+    size -= read_size;
 
     return read_size;
 }
@@ -29,8 +61,7 @@ size_t Connection::available_put_back_queue() {
 }
 
 void Connection::clear_put_back_queue() {
-    queue<uint8_t> empty;
-    m_put_back_queue = empty;
+    m_put_back_queue.clear();
 }
 
 }  // namespace iac
\ No newline at end of file
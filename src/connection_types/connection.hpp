@@ -1,32 +1,84 @@
 #pragma once
 
-#include "../std_provider/queue.hpp"
+#include "../ring_buffer.hpp"
+#include "../std_provider/limits.hpp"
 #include "../std_provider/utility.hpp"
 
 namespace iac {
 
 class Connection {
    public:
+    typedef struct io_vector {
+        const void* buffer;
+        size_t size;
+    } io_vector_t;
+
+    virtual ~Connection() = default;
+
     virtual size_t read(void* buffer, size_t size) = 0;
     virtual size_t write(const void* buffer, size_t size) = 0;
 
+    // gathers all vectors into one write, falls back to consecutive calls of write()
+    virtual size_t write_vectored(const io_vector_t* vectors, size_t count);
+
     virtual bool flush() = 0;
     virtual bool clear() = 0;
 
     virtual size_t available() = 0;
 
+    // pulls pending data of the underlying transport into user space, called once per node update,
+    // returns false once the other side closed the connection
+    virtual bool prefetch() {
+        return true;
+    };
+
+    // descriptor that becomes readable when the connection can make progress, -1 if it can't be waited on
+    virtual int file_descriptor() const {
+        return -1;
+    };
+
+    // bytes already held in user space, which waiting on the file descriptor would not report
+    virtual size_t buffered() const {
+        return m_put_back_queue.size();
+    };
+
     virtual bool open() = 0;
     virtual bool close() = 0;
 
+    // datagram connections send every write_vectored() as one message, which can't be retried in pieces,
+    // and read one received message at a time
+    virtual bool datagram_oriented() const {
+        return false;
+    };
+
+    // largest frame the connection delivers as one unit, larger packages are fragmented to fit
+    virtual size_t max_frame_size() const {
+        return numeric_limits<size_t>::max();
+    };
+
+    // true while open() could not complete immediately and has to be called again to finish
+    virtual bool open_pending() const {
+        return false;
+    };
+
     void put_back(const void* buffer, size_t size);
 
+    // copies the next `size` bytes without removing them from the connection
+    size_t peek(void* buffer, size_t size);
+    // drops the next `size` bytes, usually after inspecting them with peek()
+    size_t consume(size_t size);
+
    protected:
     size_t read_put_back_queue(void*& buffer, size_t& size);
     void clear_put_back_queue();
     size_t available_put_back_queue();
 
+    RingBuffer& put_back_queue() {
+        return m_put_back_queue;
+    };
+
    private:
-    queue<uint8_t> m_put_back_queue;
+    RingBuffer m_put_back_queue;
 };
 
 }  // namespace iac
\ No newline at end of file
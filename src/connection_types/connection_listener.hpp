@@ -0,0 +1,21 @@
+#pragma once
+
+#include "connection.hpp"
+
+namespace iac {
+
+// hands out connections for peers which connect to the node, every accepted connection gets its own route
+class ConnectionListener {
+   public:
+    virtual ~ConnectionListener() = default;
+
+    // returns an already opened connection, which is owned by the caller, or nullptr if no peer is waiting
+    virtual Connection* accept() = 0;
+
+    // descriptor that becomes readable when a peer is waiting, -1 if it can't be waited on
+    virtual int file_descriptor() const {
+        return -1;
+    };
+};
+
+}  // namespace iac
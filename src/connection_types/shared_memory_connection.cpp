@@ -0,0 +1,189 @@
+#include "shared_memory_connection.hpp"
+
+#ifdef IAC_HAS_SHARED_MEMORY
+
+#    include <cerrno>
+#    include <new>
+
+#    include "../logging.hpp"
+
+namespace iac {
+
+constexpr size_t SharedMemoryRegion::s_default_ring_capacity;
+constexpr size_t SharedMemoryRegion::s_num_directions;
+constexpr uint32_t SharedMemoryRegion::s_magic;
+
+SharedMemoryRegion::SharedMemoryRegion(size_t ring_capacity) {
+    size_t capacity = SpscRingBuffer::s_cache_line_size;
+    while (capacity < ring_capacity)
+        capacity *= 2;
+
+    const size_t size = data_offset() + s_num_directions * capacity;
+
+    if ((m_memory_fd = memfd_create("iac-shared-memory", MFD_CLOEXEC)) < 0 || ftruncate(m_memory_fd, size) < 0 || !map(size)) {
+        iac_log(Logging::loglevels::error, "could not create shared memory region %d - %s\n", errno, strerror(errno));
+        release();
+        return;
+    }
+
+    for (auto& event_fd : m_event_fds) {
+        if ((event_fd = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC)) < 0) {
+            iac_log(Logging::loglevels::error, "could not create eventfd %d - %s\n", errno, strerror(errno));
+            release();
+            return;
+        }
+    }
+
+    m_header = new (m_header) header_t{};
+    m_header->ring_capacity = capacity;
+    m_header->magic = s_magic;
+}
+
+SharedMemoryRegion::SharedMemoryRegion(int memory_fd, int event_fd1, int event_fd2)
+    : m_memory_fd(memory_fd), m_event_fds{event_fd1, event_fd2} {
+    struct stat memory_stat {};
+
+    if (fstat(m_memory_fd, &memory_stat) < 0 || (size_t)memory_stat.st_size < data_offset() || !map(memory_stat.st_size)) {
+        iac_log(Logging::loglevels::error, "could not map shared memory region %d - %s\n", errno, strerror(errno));
+        release();
+        return;
+    }
+
+    if (m_header->magic != s_magic || data_offset() + s_num_directions * m_header->ring_capacity > m_mapping_size) {
+        iac_log(Logging::loglevels::error, "descriptor does not hold a shared memory region\n");
+        release();
+        return;
+    }
+}
+
+SharedMemoryRegion::~SharedMemoryRegion() {
+    release();
+}
+
+bool SharedMemoryRegion::map(size_t size) {
+    void* mapping = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, m_memory_fd, 0);
+    if (mapping == MAP_FAILED) return false;
+
+    m_header = (header_t*)mapping;
+    m_mapping_size = size;
+    return true;
+}
+
+void SharedMemoryRegion::release() {
+    if (m_header != nullptr) munmap(m_header, m_mapping_size);
+    m_header = nullptr;
+    m_mapping_size = 0;
+
+    if (m_memory_fd >= 0) ::close(m_memory_fd);
+    m_memory_fd = -1;
+
+    for (auto& event_fd : m_event_fds) {
+        if (event_fd >= 0) ::close(event_fd);
+        event_fd = -1;
+    }
+}
+
+SpscRingBuffer SharedMemoryRegion::ring(size_t direction) {
+    if (m_header == nullptr) return {};
+
+    auto* data = (uint8_t*)m_header + data_offset() + direction * m_header->ring_capacity;
+    return {&m_header->directions[direction].control, data, m_header->ring_capacity};
+}
+
+std::atomic<uint32_t>& SharedMemoryRegion::signaled(size_t direction) {
+    return m_header->directions[direction].signaled;
+}
+
+SharedMemoryConnection::SharedMemoryConnection(SharedMemoryRegion* region, uint8_t end)
+    : m_region(region), m_read_direction(end == 0 ? 1 : 0), m_write_direction(end == 0 ? 0 : 1) {
+    m_read_ring = m_region->ring(m_read_direction);
+    m_write_ring = m_region->ring(m_write_direction);
+}
+
+size_t SharedMemoryConnection::read(void* buffer, size_t size) {
+    size_t read_size = read_put_back_queue(buffer, size);
+    return read_size + m_read_ring.pop(buffer, size);
+}
+
+size_t SharedMemoryConnection::write(const void* buffer, size_t size) {
+    return m_write_ring.push(buffer, size) ? size : 0;
+}
+
+size_t SharedMemoryConnection::write_vectored(const io_vector_t* vectors, size_t count) {
+    size_t total_size = 0;
+    for (size_t i = 0; i < count; i++)
+        total_size += vectors[i].size;
+
+    if (total_size > m_write_ring.free_space()) return 0;
+
+    // NOTE: there is only one producer, so the checked space can't shrink in between
+    for (size_t i = 0; i < count; i++)
+        m_write_ring.push(vectors[i].buffer, vectors[i].size);
+
+    return total_size;
+}
+
+bool SharedMemoryConnection::flush() {
+    if (!*m_region) return false;
+
+    // NOTE: a reader which was signaled before, but didn't wake up yet, will see this data as well
+    if (m_region->signaled(m_write_direction).exchange(1, std::memory_order_acq_rel) == 0) {
+        const uint64_t increment = 1;
+        if (::write(m_region->event_fd(m_write_direction), &increment, sizeof(increment)) < 0 && errno != EAGAIN)
+            return false;
+    }
+
+    return true;
+}
+
+bool SharedMemoryConnection::clear() {
+    clear_put_back_queue();
+    m_read_ring.consume(m_read_ring.size());
+    return true;
+}
+
+size_t SharedMemoryConnection::available() {
+    return m_read_ring.size() + available_put_back_queue();
+}
+
+bool SharedMemoryConnection::prefetch() {
+    if (!*m_region) return true;
+
+    auto& signaled = m_region->signaled(m_read_direction);
+    if (signaled.load(std::memory_order_relaxed) == 0) return true;
+
+    // NOTE: the descriptor is drained before the flag is reset, so no signal of the writer can get lost
+    uint64_t count = 0;
+    if (::read(m_region->event_fd(m_read_direction), &count, sizeof(count)) < 0 && errno != EAGAIN)
+        iac_log(Logging::loglevels::warning, "could not read eventfd %d - %s\n", errno, strerror(errno));
+
+    signaled.exchange(0, std::memory_order_acq_rel);
+    return true;
+}
+
+size_t SharedMemoryConnection::buffered() const {
+    return m_read_ring.size() + Connection::buffered();
+}
+
+bool SharedMemoryConnection::open() {
+    return (bool)*m_region;
+}
+
+bool SharedMemoryConnection::close() {
+    clear_put_back_queue();
+    if (!*m_region) return true;
+
+    // NOTE: this end is the only reader of its ring, so nothing the old connection left behind reaches the next one
+    m_read_ring.consume(m_read_ring.size());
+
+    uint64_t count = 0;
+    if (::read(m_region->event_fd(m_read_direction), &count, sizeof(count)) < 0 && errno != EAGAIN)
+        iac_log(Logging::loglevels::warning, "could not read eventfd %d - %s\n", errno, strerror(errno));
+
+    m_region->signaled(m_read_direction).store(0, std::memory_order_release);
+    return true;
+}
+
+}  // namespace iac
+
+#endif
@@ -0,0 +1,113 @@
+#pragma once
+
+#if defined(__linux__) && !defined(ARDUINO)
+#    define IAC_HAS_SHARED_MEMORY
+
+#    include <sys/eventfd.h>
+#    include <sys/mman.h>
+#    include <sys/stat.h>
+#    include <unistd.h>
+
+#    include "../spsc_ring_buffer.hpp"
+#    include "connection.hpp"
+
+namespace iac {
+
+// memory mapping with one lock-free ring per direction, shared by the two ends of a route
+// a region can be used by two processes, if they inherit it over fork() or pass its descriptors over a unix socket
+class SharedMemoryRegion {
+   public:
+    static constexpr size_t s_default_ring_capacity = 1 << 20;
+    static constexpr size_t s_num_directions = 2;
+
+    // creates a new region, `ring_capacity` is rounded up to a power of two
+    explicit SharedMemoryRegion(size_t ring_capacity = s_default_ring_capacity);
+    // maps a region created elsewhere, the descriptors are adopted and closed with the region
+    SharedMemoryRegion(int memory_fd, int event_fd1, int event_fd2);
+    ~SharedMemoryRegion();
+
+    SharedMemoryRegion(const SharedMemoryRegion&) = delete;
+    SharedMemoryRegion& operator=(const SharedMemoryRegion&) = delete;
+
+    explicit operator bool() const {
+        return m_header != nullptr;
+    };
+
+    int memory_fd() const {
+        return m_memory_fd;
+    };
+
+    int event_fd(size_t direction) const {
+        return m_event_fds[direction];
+    };
+
+    SpscRingBuffer ring(size_t direction);
+
+    // NOTE: set by the writer when it signaled the event descriptor, cleared by the reader once it woke up
+    std::atomic<uint32_t>& signaled(size_t direction);
+
+   private:
+    static constexpr uint32_t s_magic = 0x69616373;
+
+    typedef struct direction {
+        SpscRingBuffer::control_t control;
+        alignas(SpscRingBuffer::s_cache_line_size) std::atomic<uint32_t> signaled{0};
+    } direction_t;
+
+    typedef struct header {
+        uint32_t magic;
+        size_t ring_capacity;
+        direction_t directions[s_num_directions];
+    } header_t;
+
+    static size_t data_offset() {
+        return (sizeof(header_t) + SpscRingBuffer::s_cache_line_size - 1) & ~(SpscRingBuffer::s_cache_line_size - 1);
+    };
+
+    bool map(size_t size);
+    void release();
+
+    int m_memory_fd{-1};
+    int m_event_fds[s_num_directions]{-1, -1};
+
+    header_t* m_header{nullptr};
+    size_t m_mapping_size{0};
+};
+
+// one end of a SharedMemoryRegion, end 0 writes into direction 0 and reads from direction 1, end 1 vice versa
+// data never passes through the kernel, the event descriptor is only signaled once per wake up of the reader
+class SharedMemoryConnection : public Connection {
+   public:
+    SharedMemoryConnection(SharedMemoryRegion* region, uint8_t end);
+
+    size_t read(void* buffer, size_t size) override;
+    // NOTE: writes are all or nothing, a full ring would otherwise leave a partial package behind
+    size_t write(const void* buffer, size_t size) override;
+    size_t write_vectored(const io_vector_t* vectors, size_t count) override;
+
+    bool flush() override;
+    bool clear() override;
+
+    size_t available() override;
+
+    bool prefetch() override;
+
+    int file_descriptor() const override {
+        return m_region->event_fd(m_read_direction);
+    };
+
+    size_t buffered() const override;
+
+    bool open() override;
+    bool close() override;
+
+   private:
+    SharedMemoryRegion* m_region{nullptr};
+    size_t m_read_direction{0}, m_write_direction{0};
+
+    SpscRingBuffer m_read_ring, m_write_ring;
+};
+
+}  // namespace iac
+
+#endif
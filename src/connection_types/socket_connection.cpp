@@ -6,8 +6,12 @@
 
 namespace iac {
 
-SocketConnection::SocketConnection(const char* ip, int port)
-    : m_ip(ip), m_port(port) {
+constexpr size_t SocketConnection::s_max_write_vectors;
+constexpr size_t SocketConnection::s_prefetch_size;
+constexpr size_t SocketConnection::s_max_prefetched_size;
+
+SocketConnection::SocketConnection(const char* ip, int port, read_mode_t mode)
+    : m_ip(ip), m_port(port), m_read_mode(mode) {
     signal(SIGPIPE, SIG_IGN);
 
     if (ip != nullptr)
@@ -18,11 +22,13 @@ size_t SocketConnection::read(void* buffer, size_t size) {
     if (m_rw_fd == -1) return 0;
 
     size_t queue_read_size = read_put_back_queue(buffer, size);
-    size_t socket_read_size = ::read(m_rw_fd, buffer, size);
+    if (size == 0 || m_read_mode == read_mode::BUFFERED) return queue_read_size;
+
+    ssize_t socket_read_size = ::read(m_rw_fd, buffer, size);
 
     // printf("write: [%d] %lu\n", m_rw_fd, size);
 
-    return queue_read_size + socket_read_size;
+    return queue_read_size + (socket_read_size < 0 ? 0 : socket_read_size);
 }
 
 size_t SocketConnection::write(const void* buffer, size_t size) {
@@ -30,13 +36,42 @@ size_t SocketConnection::write(const void* buffer, size_t size) {
 
     // printf("write: [%d] %lu\n", m_rw_fd, size);
 
-    return ::write(m_rw_fd, buffer, size);
+    ssize_t written_size = ::write(m_rw_fd, buffer, size);
+    return written_size < 0 ? 0 : written_size;
 }
 
-bool SocketConnection::flush() {
-    if (m_rw_fd == -1) return false;
+size_t SocketConnection::write_vectored(const io_vector_t* vectors, size_t count) {
+    if (m_rw_fd == -1) return 0;
+
+    iovec io_vectors[s_max_write_vectors];
+    size_t written_size = 0;
+
+    while (count > 0) {
+        size_t batch_count = min_of(count, s_max_write_vectors);
+        size_t batch_size = 0;
+
+        for (size_t i = 0; i < batch_count; i++) {
+            io_vectors[i].iov_base = const_cast<void*>(vectors[i].buffer);
+            io_vectors[i].iov_len = vectors[i].size;
+            batch_size += vectors[i].size;
+        }
+
+        ssize_t batch_written_size = ::writev(m_rw_fd, io_vectors, batch_count);
+        if (batch_written_size < 0) break;
+
+        written_size += batch_written_size;
+        if ((size_t)batch_written_size != batch_size) break;
+
+        vectors += batch_count;
+        count -= batch_count;
+    }
 
-    return fsync(m_rw_fd) == 0;
+    return written_size;
+}
+
+bool SocketConnection::flush() {
+    // NOTE: data is handed to the kernel on write, fsync() is not supported on sockets
+    return m_rw_fd != -1;
 }
 
 bool SocketConnection::clear() {
@@ -56,6 +91,9 @@ bool SocketConnection::clear() {
 size_t SocketConnection::available() {
     if (m_rw_fd == -1) return 0;
 
+    if (m_read_mode == read_mode::BUFFERED)
+        return available_put_back_queue();
+
     unsigned long count = 0;
     ioctl(m_rw_fd, FIONREAD, &count);
 
@@ -64,146 +102,153 @@ size_t SocketConnection::available() {
     return count + available_put_back_queue();
 }
 
-SocketClientConnection::SocketClientConnection(const char* ip, int port)
-    : SocketConnection(ip, port) {
-    m_address.sin_family = AF_INET;
-    m_address.sin_addr.s_addr = m_addr;
-    m_address.sin_port = htons(m_port);
-}
-
-bool SocketClientConnection::open() {
-    if ((m_rw_fd = socket(AF_INET, SOCK_STREAM, 0)) == 0)
-        return false;
-
-    int opts = fcntl(m_rw_fd, F_GETFL, NULL);
-    if (opts < 0) return false;
+bool SocketConnection::prefetch() {
+    // NOTE: in DIRECT mode the data stays in the socket, a closed connection is reported by LocalNode::poll()
+    //       or runs into the dead timeout of the route, instead of checking with another syscall on every update
+    if (m_rw_fd == -1 || m_read_mode != read_mode::BUFFERED) return true;
 
-    opts &= (~O_NONBLOCK);
-    if (fcntl(m_rw_fd, F_SETFL, opts) < 0)
-        return false;
+    if (available_put_back_queue() >= s_max_prefetched_size) return true;
 
-    socklen_t len = sizeof(int);
+    size_t contiguous_size = 0;
+    uint8_t* buffer = put_back_queue().back(s_prefetch_size, contiguous_size);
 
-    struct timeval tv {};
-    tv.tv_sec = 0;
-    tv.tv_usec = s_connect_timeout;
+    ssize_t received_size = ::recv(m_rw_fd, buffer, contiguous_size, MSG_DONTWAIT);
+    if (received_size > 0)
+        put_back_queue().commit(received_size);
 
-    fd_set fds;
+    return !connection_lost(received_size);
+}
 
-    if (setsockopt(m_rw_fd, SOL_SOCKET, SO_RCVTIMEO, &tv, sizeof(tv)) != 0) {
-        iac_log(Logging::loglevels::network, "Failed setting receive timout\n");
+bool SocketConnection::connection_lost(ssize_t received_size) {
+    // NOTE: recv() returns 0 only after the peer shut the connection down
+    if (received_size == 0) return true;
+    return received_size < 0 && errno != EAGAIN && errno != EWOULDBLOCK && errno != EINTR;
+}
 
-        return false;
+int SocketConnection::open_listening_socket(int domain, const sockaddr* address, socklen_t address_length, int backlog) {
+    int fd = socket(domain, SOCK_STREAM, 0);
+    if (fd < 0) {
+        iac_log(Logging::loglevels::network, "Error creating socket %d - %s\n", errno, strerror(errno));
+        return -1;
     }
 
-    if (setsockopt(m_rw_fd, SOL_SOCKET, SO_SNDTIMEO, &tv, sizeof(tv)) != 0) {
-        iac_log(Logging::loglevels::network, "Failed setting send timout\n");
+    int opt = 1;
+    if (!set_non_blocking(fd) ||
+        (domain != AF_UNIX && (setsockopt(fd, SOL_SOCKET, SO_REUSEADDR, &opt, sizeof(opt)) < 0 ||
+                               setsockopt(fd, SOL_SOCKET, SO_REUSEPORT, &opt, sizeof(opt)) < 0))) {
+        iac_log(Logging::loglevels::network, "Error setting socket options %d - %s\n", errno, strerror(errno));
+        ::close(fd);
+        return -1;
+    }
 
-        return false;
+    if (bind(fd, address, address_length) < 0 || listen(fd, backlog) < 0) {
+        iac_log(Logging::loglevels::network, "Error in bind() or listen() %d - %s\n", errno, strerror(errno));
+        ::close(fd);
+        return -1;
     }
 
-    if (connect(m_rw_fd, (sockaddr*)&m_address, sizeof(m_address)) < 0) {
-        if (errno == EINPROGRESS) {
-            FD_ZERO(&fds);
-            FD_SET(m_rw_fd, &fds);
-            int result = select(m_rw_fd + 1, nullptr, &fds, nullptr, &tv);
+    return fd;
+}
 
-            if (result < 0 && errno == EINTR) {
-                iac_log(Logging::loglevels::network, "Error connecting %d - %s\n", errno, strerror(errno));
+SocketClientConnection::SocketClientConnection(const char* ip, int port, read_mode_t mode)
+    : SocketConnection(ip, port, mode) {
+    m_address.sin_family = AF_INET;
+    m_address.sin_addr.s_addr = m_addr;
+    m_address.sin_port = htons(m_port);
+}
 
-                return false;
-            }
-            if (result > 0) {
-                int valopt = -1;
-                if (getsockopt(m_rw_fd, SOL_SOCKET, SO_ERROR, (void*)(&valopt), &len) < 0) {
-                    iac_log(Logging::loglevels::network, "Error in getsockopt() %d - %s\n", errno, strerror(errno));
+bool SocketConnection::set_non_blocking(int fd) {
+    int opts = fcntl(fd, F_GETFL, NULL);
+    if (opts < 0) return false;
 
-                    return false;
-                }
+    return fcntl(fd, F_SETFL, opts | O_NONBLOCK) >= 0;
+}
 
-                if (valopt != 0) {
-                    iac_log(Logging::loglevels::network, "Error in delayed connection() %d - %s\n", valopt, strerror(valopt));
+bool SocketConnection::start_connect(int domain, const sockaddr* address, socklen_t address_length) {
+    if ((m_rw_fd = socket(domain, SOCK_STREAM, 0)) < 0) {
+        iac_log(Logging::loglevels::network, "Error creating socket %d - %s\n", errno, strerror(errno));
+        m_rw_fd = -1;
+        return false;
+    }
 
-                    return false;
-                }
+    if (!set_non_blocking(m_rw_fd)) {
+        iac_log(Logging::loglevels::network, "Error setting socket non blocking %d - %s\n", errno, strerror(errno));
+        abort_connect();
+        return false;
+    }
 
-            } else {
-                iac_log(Logging::loglevels::network, "Timeout in select() - Cancelling!\n");
+    if (connect(m_rw_fd, address, address_length) == 0)
+        return true;
 
-                return false;
-            }
+    if (errno != EINPROGRESS) {
+        iac_log(Logging::loglevels::network, "Error connecting %d - %s\n", errno, strerror(errno));
+        abort_connect();
+        return false;
+    }
 
-        } else {
-            iac_log(Logging::loglevels::network, "Error connecting %d - %s\n", errno, strerror(errno));
+    // NOTE: the connection is established in the background, finish_connect() picks it up once the socket is writable
+    m_connect_pending = true;
+    return false;
+}
 
-            return false;
-        }
-    }
+bool SocketConnection::finish_connect() {
+    pollfd poll_fd{};
+    poll_fd.fd = m_rw_fd;
+    poll_fd.events = POLLOUT;
 
-    if ((opts = fcntl(m_rw_fd, F_GETFL, NULL)) < 0)
-        return false;
+    int result = ::poll(&poll_fd, 1, 0);
 
-    opts |= O_NONBLOCK;
-    if (fcntl(m_rw_fd, F_SETFL, opts) < 0)
+    if (result == 0 || (result < 0 && errno == EINTR))
         return false;
 
-    tv.tv_sec = 1;
-    tv.tv_usec = 0;
-
-    if (setsockopt(m_rw_fd, SOL_SOCKET, SO_RCVTIMEO, &tv, sizeof(tv)) != 0) {
-        iac_log(Logging::loglevels::network, "Failed setting receive timout\n");
+    int valopt = -1;
+    socklen_t len = sizeof(valopt);
 
+    if (result < 0 || getsockopt(m_rw_fd, SOL_SOCKET, SO_ERROR, (void*)(&valopt), &len) < 0) {
+        iac_log(Logging::loglevels::network, "Error in poll() or getsockopt() %d - %s\n", errno, strerror(errno));
+        abort_connect();
         return false;
     }
 
-    if (setsockopt(m_rw_fd, SOL_SOCKET, SO_SNDTIMEO, &tv, sizeof(tv)) != 0) {
-        iac_log(Logging::loglevels::network, "Failed setting send timout\n");
-
+    if (valopt != 0) {
+        iac_log(Logging::loglevels::network, "Error in delayed connection() %d - %s\n", valopt, strerror(valopt));
+        abort_connect();
         return false;
     }
 
+    m_connect_pending = false;
     return true;
 }
 
-bool SocketClientConnection::close() {
-    bool close_result = ::close(m_rw_fd) != 0;
+void SocketConnection::abort_connect() {
+    ::close(m_rw_fd);
     m_rw_fd = -1;
-    clear_put_back_queue();
-    return close_result;
+    m_connect_pending = false;
 }
 
-SocketServerConnection::SocketServerConnection(const char* ip, int port)
-    : SocketConnection(ip, port) {
-    if ((m_server_fd = socket(AF_INET, SOCK_STREAM, 0)) == 0) {
-        iac_log(Logging::loglevels::network, "socket failed\n");
-
-        m_good = false;
-        return;
-    }
-
-    fcntl(m_server_fd, F_SETFL, fcntl(m_server_fd, F_GETFL, 0) | O_NONBLOCK);
+bool SocketClientConnection::open() {
+    if (m_connect_pending)
+        return finish_connect();
 
-    int opt = 1;
-    if (setsockopt(m_server_fd, SOL_SOCKET, SO_REUSEADDR | SO_REUSEPORT, &opt, sizeof(opt)) < 0) {
-        iac_log(Logging::loglevels::network, "setsockopt\n");
+    return start_connect(AF_INET, (sockaddr*)&m_address, sizeof(m_address));
+}
 
-        m_good = false;
-        return;
-    }
+bool SocketClientConnection::close() {
+    bool close_result = m_rw_fd == -1 || ::close(m_rw_fd) == 0;
+    m_rw_fd = -1;
+    m_connect_pending = false;
+    clear_put_back_queue();
+    return close_result;
+}
 
+SocketServerConnection::SocketServerConnection(const char* ip, int port, read_mode_t mode)
+    : SocketConnection(ip, port, mode) {
     m_server_address.sin_family = AF_INET;
     m_server_address.sin_addr.s_addr = m_addr;
     m_server_address.sin_port = htons(m_port);
 
-    if (bind(m_server_fd, (struct sockaddr*)&m_server_address, sizeof(m_server_address)) < 0) {
-        iac_log(Logging::loglevels::network, "bind to %s %d failed\n", m_ip, m_port);
-
-        m_good = false;
-        return;
-    }
-
-    if (listen(m_server_fd, 0) < 0) {
-        iac_log(Logging::loglevels::network, "listen\n");
+    if ((m_server_fd = open_listening_socket(AF_INET, (sockaddr*)&m_server_address, sizeof(m_server_address), 0)) < 0) {
+        iac_log(Logging::loglevels::network, "listening on %s %d failed\n", m_ip, m_port);
 
         m_good = false;
         return;
@@ -213,16 +258,68 @@ SocketServerConnection::SocketServerConnection(const char* ip, int port)
 bool SocketServerConnection::open() {
     socklen_t addr_len = sizeof(m_client_address);
 
-    return (m_rw_fd = accept(m_server_fd, (struct sockaddr*)&m_client_address, &addr_len)) >= 0;
+    if ((m_rw_fd = accept(m_server_fd, (struct sockaddr*)&m_client_address, &addr_len)) < 0) return false;
+
+    // NOTE: like on client sockets, a full socket buffer shortens the write instead of blocking the node
+    set_non_blocking(m_rw_fd);
+    return true;
 }
 
 bool SocketServerConnection::close() {
-    bool close_result = ::close(m_rw_fd) == 0;
+    bool close_result = m_rw_fd == -1 || ::close(m_rw_fd) == 0;
+    m_rw_fd = -1;
+    clear_put_back_queue();
+    return close_result;
+}
+
+SocketAcceptedConnection::SocketAcceptedConnection(int fd, read_mode_t mode)
+    : SocketConnection(nullptr, 0, mode) {
+    m_rw_fd = fd;
+    set_non_blocking(m_rw_fd);
+}
+
+SocketAcceptedConnection::~SocketAcceptedConnection() {
+    close();
+}
+
+bool SocketAcceptedConnection::close() {
+    bool close_result = m_rw_fd == -1 || ::close(m_rw_fd) == 0;
     m_rw_fd = -1;
     clear_put_back_queue();
     return close_result;
 }
 
+SocketListener::SocketListener(const char* ip, int port, SocketConnection::read_mode_t mode, int backlog)
+    : m_read_mode(mode) {
+    sockaddr_in address{};
+    address.sin_family = AF_INET;
+    address.sin_addr.s_addr = INADDR_ANY;
+    address.sin_port = htons(port);
+
+    if (ip != nullptr)
+        inet_pton(AF_INET, ip, &address.sin_addr);
+
+    if ((m_server_fd = SocketConnection::open_listening_socket(AF_INET, (sockaddr*)&address, sizeof(address), backlog)) < 0)
+        iac_log(Logging::loglevels::network, "listening on %s %d failed\n", ip != nullptr ? ip : "*", port);
+}
+
+SocketListener::~SocketListener() {
+    if (m_server_fd != -1) ::close(m_server_fd);
+}
+
+Connection* SocketListener::accept() {
+    if (m_server_fd == -1) return nullptr;
+
+    int fd = ::accept(m_server_fd, nullptr, nullptr);
+    if (fd < 0) {
+        if (errno != EAGAIN && errno != EWOULDBLOCK)
+            iac_log(Logging::loglevels::network, "Error accepting connection %d - %s\n", errno, strerror(errno));
+        return nullptr;
+    }
+
+    return new SocketAcceptedConnection(fd, m_read_mode);
+}
+
 }  // namespace iac
 
 #endif
\ No newline at end of file
@@ -4,9 +4,11 @@
 
 #    include <arpa/inet.h>
 #    include <netinet/in.h>
+#    include <poll.h>
 #    include <sys/fcntl.h>
 #    include <sys/ioctl.h>
 #    include <sys/socket.h>
+#    include <sys/uio.h>
 #    include <unistd.h>
 
 #    include <csignal>
@@ -15,39 +17,82 @@
 
 #    include "../std_provider/string.hpp"
 #    include "connection.hpp"
+#    include "connection_listener.hpp"
 
 namespace iac {
 
 class SocketConnection : public Connection {
    public:
-    SocketConnection(const char* ip, int port);
+    // DIRECT:    every read() and available() is served by the socket
+    // BUFFERED:  prefetch() drains the socket into user space with one recv() per node update,
+    //            read() and available() are served from memory
+    enum class read_mode {
+        DIRECT,
+        BUFFERED
+    };
+
+    typedef read_mode read_mode_t;
+
+    SocketConnection(const char* ip, int port, read_mode_t mode = read_mode::DIRECT);
 
     size_t read(void* buffer, size_t size) override;
     size_t write(const void* buffer, size_t size) override;
+    size_t write_vectored(const io_vector_t* vectors, size_t count) override;
 
     bool flush() override;
     bool clear() override;
 
     size_t available() override;
 
+    bool prefetch() override;
+
+    int file_descriptor() const override {
+        return m_rw_fd;
+    };
+
+    bool open_pending() const override {
+        return m_connect_pending;
+    };
+
     explicit operator bool() const {
         return m_good;
     };
 
+    // creates a non blocking socket listening on `address`, returns -1 on failure
+    static int open_listening_socket(int domain, const sockaddr* address, socklen_t address_length, int backlog);
+
    protected:
+    static constexpr size_t s_max_write_vectors = 16;
+    static constexpr size_t s_prefetch_size = 16384;
+    // NOTE: once this much is buffered the socket isn't drained any further, so a peer which sends faster than the
+    //       node reads is held back by the kernel instead of growing the buffer
+    static constexpr size_t s_max_prefetched_size = 4 * s_prefetch_size;
+
+    static bool set_non_blocking(int fd);
+    // true if the result of a recv() tells that the connection is gone
+    static bool connection_lost(ssize_t received_size);
+
+    // non blocking connect, returns false while the connection is still being established
+    bool start_connect(int domain, const sockaddr* address, socklen_t address_length);
+    bool finish_connect();
+    void abort_connect();
+
     const char* m_ip = nullptr;
     int m_port = 0;
 
+    read_mode_t m_read_mode = read_mode::DIRECT;
+
     in_addr_t m_addr = INADDR_ANY;
 
     int m_rw_fd = -1;
+    bool m_connect_pending = false;
 
     bool m_good = true;
 };
 
 class SocketClientConnection : public SocketConnection {
    public:
-    SocketClientConnection(const char* ip, int port);
+    SocketClientConnection(const char* ip, int port, read_mode_t mode = read_mode::DIRECT);
 
     bool open() override;
     bool close() override;
@@ -56,17 +101,20 @@ class SocketClientConnection : public SocketConnection {
 
    private:
     sockaddr_in m_address{};
-
-    static constexpr unsigned s_connect_timeout = 100000;
 };
 
 class SocketServerConnection : public SocketConnection {
    public:
-    SocketServerConnection(const char* ip, int port);
+    SocketServerConnection(const char* ip, int port, read_mode_t mode = read_mode::DIRECT);
 
     bool open() override;
     bool close() override;
 
+    // NOTE: while no client is accepted, the listening socket signals a pending connection
+    int file_descriptor() const override {
+        return m_rw_fd != -1 ? m_rw_fd : m_server_fd;
+    };
+
     void printBuffer(int cols = 4);
 
    private:
@@ -74,6 +122,46 @@ class SocketServerConnection : public SocketConnection {
     sockaddr_in m_server_address{}, m_client_address{};
 };
 
+// wraps a socket handed out by SocketListener, it can't be reopened once closed
+class SocketAcceptedConnection : public SocketConnection {
+   public:
+    SocketAcceptedConnection(int fd, read_mode_t mode = read_mode::DIRECT);
+    ~SocketAcceptedConnection() override;
+
+    SocketAcceptedConnection(const SocketAcceptedConnection&) = delete;
+    SocketAcceptedConnection& operator=(const SocketAcceptedConnection&) = delete;
+
+    bool open() override {
+        return m_rw_fd != -1;
+    };
+
+    bool close() override;
+};
+
+// accepts any number of clients on one port, unlike SocketServerConnection which serves one client at a time
+class SocketListener : public ConnectionListener {
+   public:
+    SocketListener(const char* ip, int port, SocketConnection::read_mode_t mode = SocketConnection::read_mode::DIRECT, int backlog = SOMAXCONN);
+    ~SocketListener() override;
+
+    SocketListener(const SocketListener&) = delete;
+    SocketListener& operator=(const SocketListener&) = delete;
+
+    Connection* accept() override;
+
+    int file_descriptor() const override {
+        return m_server_fd;
+    };
+
+    explicit operator bool() const {
+        return m_server_fd != -1;
+    };
+
+   private:
+    SocketConnection::read_mode_t m_read_mode;
+    int m_server_fd{-1};
+};
+
 }  // namespace iac
 
 #endif
\ No newline at end of file
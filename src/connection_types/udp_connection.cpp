@@ -0,0 +1,224 @@
+#include "udp_connection.hpp"
+
+#ifdef IAC_HAS_UDP
+
+#    include "../logging.hpp"
+
+namespace iac {
+
+constexpr size_t UdpConnection::s_default_max_datagram_size;
+constexpr size_t UdpConnection::s_max_batch_size;
+constexpr size_t UdpConnection::s_max_buffered_size;
+
+UdpConnection::UdpConnection(const char* local_ip, int local_port, const char* remote_ip, int remote_port, size_t max_datagram_size)
+    : SocketConnection(remote_ip, remote_port, read_mode::BUFFERED), m_max_datagram_size(max_datagram_size) {
+    m_remote_address.sin_family = AF_INET;
+    m_remote_address.sin_addr.s_addr = m_addr;
+    m_remote_address.sin_port = htons(remote_port);
+
+    m_local_address.sin_family = AF_INET;
+    m_local_address.sin_addr.s_addr = INADDR_ANY;
+    m_local_address.sin_port = htons(local_port);
+
+    if (local_ip != nullptr)
+        inet_pton(AF_INET, local_ip, &m_local_address.sin_addr);
+}
+
+UdpConnection::~UdpConnection() {
+    close();
+
+    delete[] m_send_buffer;
+    delete[] m_receive_buffer;
+}
+
+uint8_t* UdpConnection::queue_datagram(size_t size) {
+    if (size > m_max_datagram_size) {
+        iac_log(Logging::loglevels::warning, "package of %lu bytes exceeds the maximum datagram size of %lu\n", size, m_max_datagram_size);
+        return nullptr;
+    }
+
+    if (m_num_queued_datagrams == s_max_batch_size && !flush()) return nullptr;
+
+    if (m_send_buffer_size + size > m_send_buffer_capacity) {
+        // NOTE: datagrams are referenced by offset, so moving the buffer keeps them valid
+        m_send_buffer_capacity = max_of(m_send_buffer_size + size, m_send_buffer_capacity * 2);
+
+        auto* send_buffer = new uint8_t[m_send_buffer_capacity];
+        memcpy(send_buffer, m_send_buffer, m_send_buffer_size);
+
+        delete[] m_send_buffer;
+        m_send_buffer = send_buffer;
+    }
+
+    m_datagram_offsets[m_num_queued_datagrams] = m_send_buffer_size;
+    m_datagram_sizes[m_num_queued_datagrams] = size;
+    m_num_queued_datagrams++;
+
+    uint8_t* datagram = m_send_buffer + m_send_buffer_size;
+    m_send_buffer_size += size;
+
+    return datagram;
+}
+
+size_t UdpConnection::read(void* buffer, size_t size) {
+    size_t read_size = read_put_back_queue(buffer, size);
+
+    // NOTE: a read never continues into the next datagram
+    if (read_size == 0) next_datagram();
+
+    const size_t datagram_read_size = m_received_datagrams.pop(buffer, min_of(size, m_current_datagram_left));
+    m_current_datagram_left -= datagram_read_size;
+
+    return read_size + datagram_read_size;
+}
+
+size_t UdpConnection::write(const void* buffer, size_t size) {
+    const io_vector_t vector{buffer, size};
+    return write_vectored(&vector, 1);
+}
+
+size_t UdpConnection::write_vectored(const io_vector_t* vectors, size_t count) {
+    if (m_rw_fd == -1) return 0;
+
+    size_t total_size = 0;
+    for (size_t i = 0; i < count; i++)
+        total_size += vectors[i].size;
+
+    uint8_t* cursor = queue_datagram(total_size);
+    if (cursor == nullptr) return 0;
+
+    for (size_t i = 0; i < count; i++) {
+        memcpy(cursor, vectors[i].buffer, vectors[i].size);
+        cursor += vectors[i].size;
+    }
+
+    return total_size;
+}
+
+bool UdpConnection::flush() {
+    if (m_rw_fd == -1) return false;
+
+    iovec io_vectors[s_max_batch_size];
+    mmsghdr messages[s_max_batch_size]{};
+
+    for (size_t i = 0; i < m_num_queued_datagrams; i++) {
+        io_vectors[i].iov_base = m_send_buffer + m_datagram_offsets[i];
+        io_vectors[i].iov_len = m_datagram_sizes[i];
+
+        messages[i].msg_hdr.msg_iov = &io_vectors[i];
+        messages[i].msg_hdr.msg_iovlen = 1;
+    }
+
+    size_t sent_count = 0;
+    while (sent_count < m_num_queued_datagrams) {
+        int result = sendmmsg(m_rw_fd, messages + sent_count, m_num_queued_datagrams - sent_count, MSG_DONTWAIT);
+
+        if (result < 0) {
+            if (errno == EINTR) continue;
+
+            // NOTE: datagrams may get lost anyway, a refused or full socket drops the remaining ones
+            if (errno != EAGAIN && errno != EWOULDBLOCK && errno != ECONNREFUSED)
+                iac_log(Logging::loglevels::network, "Error in sendmmsg() %d - %s\n", errno, strerror(errno));
+            break;
+        }
+
+        sent_count += result;
+    }
+
+    m_num_queued_datagrams = 0;
+    m_send_buffer_size = 0;
+
+    return true;
+}
+
+size_t UdpConnection::available() {
+    next_datagram();
+
+    return available_put_back_queue() + m_current_datagram_left;
+}
+
+void UdpConnection::next_datagram() {
+    if (m_current_datagram_left > 0 || available_put_back_queue() > 0 || m_received_sizes.empty()) return;
+
+    m_current_datagram_left = m_received_sizes.front();
+    m_received_sizes.pop();
+}
+
+bool UdpConnection::prefetch() {
+    if (m_rw_fd == -1) return true;
+
+    const size_t buffered_size = buffered();
+    if (buffered_size >= s_max_buffered_size) return true;
+
+    // NOTE: only as many datagrams are received as surely fit below the limit, an empty buffer always takes one
+    size_t batch_size = min_of(s_max_batch_size, (s_max_buffered_size - buffered_size) / m_max_datagram_size);
+    if (batch_size == 0) {
+        if (buffered_size > 0) return true;
+        batch_size = 1;
+    }
+
+    iovec io_vectors[s_max_batch_size];
+    mmsghdr messages[s_max_batch_size]{};
+
+    for (size_t i = 0; i < batch_size; i++) {
+        io_vectors[i].iov_base = m_receive_buffer + i * m_max_datagram_size;
+        io_vectors[i].iov_len = m_max_datagram_size;
+
+        messages[i].msg_hdr.msg_iov = &io_vectors[i];
+        messages[i].msg_hdr.msg_iovlen = 1;
+    }
+
+    int result = recvmmsg(m_rw_fd, messages, batch_size, MSG_DONTWAIT, nullptr);
+
+    for (int i = 0; i < result; i++) {
+        // NOTE: a truncated datagram can't hold a complete package
+        if ((messages[i].msg_hdr.msg_flags & MSG_TRUNC) || messages[i].msg_len == 0) continue;
+
+        m_received_datagrams.push(io_vectors[i].iov_base, messages[i].msg_len);
+        m_received_sizes.push(messages[i].msg_len);
+    }
+
+    // NOTE: there is no end of a datagram connection, silence is detected by the node
+    return true;
+}
+
+bool UdpConnection::open() {
+    if ((m_rw_fd = socket(AF_INET, SOCK_DGRAM, 0)) < 0) {
+        iac_log(Logging::loglevels::network, "Error creating socket %d - %s\n", errno, strerror(errno));
+        m_rw_fd = -1;
+        return false;
+    }
+
+    int opt = 1;
+    if (!set_non_blocking(m_rw_fd) ||
+        setsockopt(m_rw_fd, SOL_SOCKET, SO_REUSEADDR, &opt, sizeof(opt)) < 0 ||
+        bind(m_rw_fd, (sockaddr*)&m_local_address, sizeof(m_local_address)) < 0 ||
+        connect(m_rw_fd, (sockaddr*)&m_remote_address, sizeof(m_remote_address)) < 0) {
+        iac_log(Logging::loglevels::network, "Error setting up udp socket %d - %s\n", errno, strerror(errno));
+        close();
+        return false;
+    }
+
+    if (m_receive_buffer == nullptr)
+        m_receive_buffer = new uint8_t[s_max_batch_size * m_max_datagram_size];
+
+    return true;
+}
+
+bool UdpConnection::close() {
+    bool close_result = m_rw_fd == -1 || ::close(m_rw_fd) == 0;
+    m_rw_fd = -1;
+    m_num_queued_datagrams = 0;
+    m_send_buffer_size = 0;
+    clear_put_back_queue();
+
+    m_received_datagrams.clear();
+    m_received_sizes = queue<size_t>{};
+    m_current_datagram_left = 0;
+
+    return close_result;
+}
+
+}  // namespace iac
+
+#endif
@@ -0,0 +1,81 @@
+#pragma once
+
+#if defined(__linux__) && !defined(ARDUINO)
+#    define IAC_HAS_UDP
+
+#    include "../std_provider/queue.hpp"
+#    include "socket_connection.hpp"
+
+namespace iac {
+
+// every package travels in its own datagram, so a lost datagram never leaves a partial package behind
+// written packages are queued until flush(), which hands all of them to the kernel with one sendmmsg(),
+// prefetch() drains up to `s_max_batch_size` datagrams per recvmmsg()
+// received datagrams are read one at a time, available() only reports the rest of the current one
+class UdpConnection : public SocketConnection {
+   public:
+    static constexpr size_t s_default_max_datagram_size = 8192;
+    static constexpr size_t s_max_batch_size = 16;
+    // NOTE: once this much is buffered prefetch() leaves further datagrams to the kernel, which drops them when its
+    //       own buffer is full, so a peer which sends faster than the node reads can't grow the buffer
+    static constexpr size_t s_max_buffered_size = s_max_prefetched_size;
+
+    // NOTE: routes fragment packages which don't fit into `max_datagram_size`
+    UdpConnection(const char* local_ip, int local_port, const char* remote_ip, int remote_port, size_t max_datagram_size = s_default_max_datagram_size);
+    ~UdpConnection() override;
+
+    UdpConnection(const UdpConnection&) = delete;
+    UdpConnection& operator=(const UdpConnection&) = delete;
+
+    size_t read(void* buffer, size_t size) override;
+    size_t write(const void* buffer, size_t size) override;
+    size_t write_vectored(const io_vector_t* vectors, size_t count) override;
+
+    bool flush() override;
+
+    size_t available() override;
+
+    bool prefetch() override;
+
+    size_t buffered() const override {
+        return Connection::buffered() + m_received_datagrams.size();
+    };
+
+    bool datagram_oriented() const override {
+        return true;
+    };
+
+    size_t max_frame_size() const override {
+        return m_max_datagram_size;
+    };
+
+    bool open() override;
+    bool close() override;
+
+   private:
+    uint8_t* queue_datagram(size_t size);
+    // moves on to the next received datagram, once the current one was read completely
+    void next_datagram();
+
+    size_t m_max_datagram_size;
+
+    sockaddr_in m_local_address{}, m_remote_address{};
+
+    uint8_t* m_send_buffer{nullptr};
+    size_t m_send_buffer_size{0}, m_send_buffer_capacity{0};
+
+    size_t m_datagram_offsets[s_max_batch_size]{};
+    size_t m_datagram_sizes[s_max_batch_size]{};
+    size_t m_num_queued_datagrams{0};
+
+    uint8_t* m_receive_buffer{nullptr};
+
+    // NOTE: the received datagrams are kept apart from the put-back queue, which only ever holds bytes of the current one
+    RingBuffer m_received_datagrams;
+    queue<size_t> m_received_sizes;
+    size_t m_current_datagram_left{0};
+};
+
+}  // namespace iac
+
+#endif
@@ -0,0 +1,135 @@
+#ifndef ARDUINO
+
+#    include "unix_socket_connection.hpp"
+
+#    include <cstddef>
+
+#    include "../logging.hpp"
+
+namespace iac {
+
+static bool make_unix_address(const char* path, sockaddr_un& address, socklen_t& address_length) {
+    const size_t path_length = strlen(path);
+
+    if (path_length == 0 || path_length >= sizeof(address.sun_path)) {
+        iac_log(Logging::loglevels::error, "invalid unix socket path '%s'\n", path);
+        return false;
+    }
+
+    address.sun_family = AF_UNIX;
+    memcpy(address.sun_path, path, path_length);
+
+    // NOTE: abstract addresses are not null terminated, their length is part of the name
+    if (path[0] == '@') {
+        address.sun_path[0] = '\0';
+        address_length = offsetof(sockaddr_un, sun_path) + path_length;
+    } else {
+        address.sun_path[path_length] = '\0';
+        address_length = sizeof(address);
+    }
+
+    return true;
+}
+
+static int listen_on_unix_path(const char* path, int backlog) {
+    sockaddr_un address{};
+    socklen_t address_length = 0;
+
+    if (!make_unix_address(path, address, address_length)) return -1;
+
+    // NOTE: a socket file left behind by a previous process would make bind() fail
+    struct stat path_stat {};
+    if (path[0] != '@' && stat(path, &path_stat) == 0 && S_ISSOCK(path_stat.st_mode))
+        unlink(path);
+
+    return SocketConnection::open_listening_socket(AF_UNIX, (sockaddr*)&address, address_length, backlog);
+}
+
+static void unlink_unix_path(const char* path) {
+    if (path[0] != '@') unlink(path);
+}
+
+UnixSocketClientConnection::UnixSocketClientConnection(const char* path, read_mode_t mode)
+    : SocketConnection(nullptr, 0, mode), m_path(path) {
+    m_good = make_unix_address(path, m_address, m_address_length);
+}
+
+bool UnixSocketClientConnection::open() {
+    if (!m_good) return false;
+
+    if (m_connect_pending)
+        return finish_connect();
+
+    return start_connect(AF_UNIX, (sockaddr*)&m_address, m_address_length);
+}
+
+bool UnixSocketClientConnection::close() {
+    bool close_result = m_rw_fd == -1 || ::close(m_rw_fd) == 0;
+    m_rw_fd = -1;
+    m_connect_pending = false;
+    clear_put_back_queue();
+    return close_result;
+}
+
+UnixSocketServerConnection::UnixSocketServerConnection(const char* path, read_mode_t mode)
+    : SocketConnection(nullptr, 0, mode), m_path(path) {
+    if ((m_server_fd = listen_on_unix_path(path, 0)) < 0) {
+        iac_log(Logging::loglevels::network, "listening on %s failed\n", path);
+
+        m_good = false;
+        return;
+    }
+}
+
+UnixSocketServerConnection::~UnixSocketServerConnection() {
+    close();
+
+    if (m_server_fd != -1) {
+        ::close(m_server_fd);
+        unlink_unix_path(m_path);
+    }
+}
+
+bool UnixSocketServerConnection::open() {
+    if (m_server_fd == -1 || (m_rw_fd = accept(m_server_fd, nullptr, nullptr)) < 0) return false;
+
+    set_non_blocking(m_rw_fd);
+    return true;
+}
+
+bool UnixSocketServerConnection::close() {
+    bool close_result = m_rw_fd == -1 || ::close(m_rw_fd) == 0;
+    m_rw_fd = -1;
+    clear_put_back_queue();
+    return close_result;
+}
+
+UnixSocketListener::UnixSocketListener(const char* path, SocketConnection::read_mode_t mode, int backlog)
+    : m_path(path), m_read_mode(mode) {
+    if ((m_server_fd = listen_on_unix_path(path, backlog)) < 0)
+        iac_log(Logging::loglevels::network, "listening on %s failed\n", path);
+}
+
+UnixSocketListener::~UnixSocketListener() {
+    if (m_server_fd != -1) {
+        ::close(m_server_fd);
+        unlink_unix_path(m_path);
+    }
+}
+
+Connection* UnixSocketListener::accept() {
+    if (m_server_fd == -1) return nullptr;
+
+    int fd = ::accept(m_server_fd, nullptr, nullptr);
+    if (fd < 0) {
+        if (errno != EAGAIN && errno != EWOULDBLOCK)
+            iac_log(Logging::loglevels::network, "Error accepting connection %d - %s\n", errno, strerror(errno));
+        return nullptr;
+    }
+
+    return new SocketAcceptedConnection(fd, m_read_mode);
+}
+
+}  // namespace iac
+
+#endif
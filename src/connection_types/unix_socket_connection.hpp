@@ -0,0 +1,76 @@
+#pragma once
+
+#ifndef ARDUINO
+
+#    include <sys/stat.h>
+#    include <sys/un.h>
+
+#    include "socket_connection.hpp"
+
+namespace iac {
+
+// NOTE: paths starting with '@' are bound in the abstract namespace (linux only), which leaves no file behind
+
+class UnixSocketClientConnection : public SocketConnection {
+   public:
+    UnixSocketClientConnection(const char* path, read_mode_t mode = read_mode::DIRECT);
+
+    bool open() override;
+    bool close() override;
+
+   private:
+    const char* m_path = nullptr;
+
+    sockaddr_un m_address{};
+    socklen_t m_address_length = 0;
+};
+
+class UnixSocketServerConnection : public SocketConnection {
+   public:
+    UnixSocketServerConnection(const char* path, read_mode_t mode = read_mode::DIRECT);
+    ~UnixSocketServerConnection() override;
+
+    UnixSocketServerConnection(const UnixSocketServerConnection&) = delete;
+    UnixSocketServerConnection& operator=(const UnixSocketServerConnection&) = delete;
+
+    bool open() override;
+    bool close() override;
+
+    // NOTE: while no client is accepted, the listening socket signals a pending connection
+    int file_descriptor() const override {
+        return m_rw_fd != -1 ? m_rw_fd : m_server_fd;
+    };
+
+   private:
+    const char* m_path = nullptr;
+    int m_server_fd{-1};
+};
+
+// accepts any number of clients on one path, see SocketListener
+class UnixSocketListener : public ConnectionListener {
+   public:
+    UnixSocketListener(const char* path, SocketConnection::read_mode_t mode = SocketConnection::read_mode::DIRECT, int backlog = SOMAXCONN);
+    ~UnixSocketListener() override;
+
+    UnixSocketListener(const UnixSocketListener&) = delete;
+    UnixSocketListener& operator=(const UnixSocketListener&) = delete;
+
+    Connection* accept() override;
+
+    int file_descriptor() const override {
+        return m_server_fd;
+    };
+
+    explicit operator bool() const {
+        return m_server_fd != -1;
+    };
+
+   private:
+    const char* m_path = nullptr;
+    SocketConnection::read_mode_t m_read_mode;
+    int m_server_fd{-1};
+};
+
+}  // namespace iac
+
+#endif
@@ -1,10 +1,15 @@
 #pragma once
 
 #include "buffer_rw.hpp"
+#include "clock.hpp"
+#include "connection_types/concurrent_loopback_connection.hpp"
 #include "connection_types/esp8266_socket_connection.hpp"
 #include "connection_types/latent_loopback_connection.hpp"
 #include "connection_types/loopback_connection.hpp"
+#include "connection_types/shared_memory_connection.hpp"
 #include "connection_types/socket_connection.hpp"
+#include "connection_types/udp_connection.hpp"
+#include "connection_types/unix_socket_connection.hpp"
 #include "local_endpoint.hpp"
 #include "local_node.hpp"
 #include "local_transport_route.hpp"
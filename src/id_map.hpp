@@ -0,0 +1,601 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+#include "exceptions.hpp"
+#include "std_provider/limits.hpp"
+#include "std_provider/string.hpp"
+#include "std_provider/utility.hpp"
+
+namespace iac {
+
+IAC_MAKE_EXCEPTION(IdMapMissingKeyException);
+
+// forward iterator over the used slots of an id map, yields pair<Key, Value> like unordered_map
+template <typename Map, typename Entry>
+class IdMapIterator {
+   public:
+    IdMapIterator(Map* map, size_t index)
+        : m_map(map), m_index(map->next_used_slot(index)){};
+
+    // NOTE: allows passing iterators wherever const iterators are expected
+    template <typename OtherMap, typename OtherEntry>
+    IdMapIterator(const IdMapIterator<OtherMap, OtherEntry>& other)
+        : m_map(other.map()), m_index(other.index()){};
+
+    Entry& operator*() const {
+        return m_map->slot_entry(m_index);
+    };
+
+    Entry* operator->() const {
+        return &m_map->slot_entry(m_index);
+    };
+
+    IdMapIterator& operator++() {
+        m_index = m_map->next_used_slot(m_index + 1);
+        return *this;
+    };
+
+    IdMapIterator operator++(int) {
+        IdMapIterator previous = *this;
+        ++*this;
+        return previous;
+    };
+
+    bool operator==(const IdMapIterator& other) const {
+        return m_index == other.m_index;
+    };
+
+    bool operator!=(const IdMapIterator& other) const {
+        return m_index != other.m_index;
+    };
+
+    Map* map() const {
+        return m_map;
+    };
+
+    size_t index() const {
+        return m_index;
+    };
+
+   private:
+    Map* m_map;
+    size_t m_index;
+};
+
+// map for ids of at most 8 bit, every possible id has its own slot and an occupancy bitmap
+// keeps iteration cheap, lookups are a single index operation
+template <typename Key, typename Value>
+class DenseIdMap {
+    template <typename Map, typename Entry>
+    friend class IdMapIterator;
+
+   public:
+    typedef pair<Key, Value> value_type;
+    typedef IdMapIterator<DenseIdMap, value_type> iterator;
+    typedef IdMapIterator<const DenseIdMap, const value_type> const_iterator;
+
+    static constexpr size_t s_num_slots = (size_t)numeric_limits<Key>::max() + 1;
+    static_assert(s_num_slots <= 256, "dense id maps are meant for 8 bit ids");
+
+    DenseIdMap() = default;
+
+    DenseIdMap(const DenseIdMap&) = delete;
+    DenseIdMap& operator=(const DenseIdMap&) = delete;
+
+    iterator begin() {
+        return {this, 0};
+    };
+
+    iterator end() {
+        return {this, s_num_slots};
+    };
+
+    const_iterator begin() const {
+        return {this, 0};
+    };
+
+    const_iterator end() const {
+        return {this, s_num_slots};
+    };
+
+    size_t size() const {
+        return m_size;
+    };
+
+    bool empty() const {
+        return m_size == 0;
+    };
+
+    iterator find(Key key) {
+        return used(key) ? iterator{this, key} : end();
+    };
+
+    const_iterator find(Key key) const {
+        return used(key) ? const_iterator{this, key} : end();
+    };
+
+    // NOTE: like unordered_map::at, a missing key is an error, as writes to the value of an unused slot
+    //       would show up once the key is inserted
+    Value& at(Key key) {
+        if (!used(key)) IAC_HANDLE_FATAL_EXCEPTION(IdMapMissingKeyException, "at() with a key which is not in the map");
+        return m_slots[key].second;
+    };
+
+    const Value& at(Key key) const {
+        if (!used(key)) IAC_HANDLE_FATAL_EXCEPTION(IdMapMissingKeyException, "at() with a key which is not in the map");
+        return m_slots[key].second;
+    };
+
+    Value& operator[](Key key) {
+        if (!used(key)) {
+            m_slots[key].first = key;
+            m_used[key / 32] |= 1u << (key % 32);
+            m_size++;
+        }
+
+        return m_slots[key].second;
+    };
+
+    size_t erase(Key key) {
+        if (!used(key)) return 0;
+
+        m_slots[key].second = Value{};
+        m_used[key / 32] &= ~(1u << (key % 32));
+        m_size--;
+        return 1;
+    };
+
+    void erase(const const_iterator& it) {
+        erase(it->first);
+    };
+
+   private:
+    bool used(size_t index) const {
+        return (m_used[index / 32] >> (index % 32)) & 1u;
+    };
+
+    size_t next_used_slot(size_t index) const {
+        while (index < s_num_slots) {
+            uint32_t word = m_used[index / 32] >> (index % 32);
+            if (word != 0) return index + __builtin_ctz(word);
+
+            index = (index / 32 + 1) * 32;
+        }
+
+        return s_num_slots;
+    };
+
+    value_type& slot_entry(size_t index) {
+        return m_slots[index];
+    };
+
+    const value_type& slot_entry(size_t index) const {
+        return m_slots[index];
+    };
+
+    value_type m_slots[s_num_slots]{};
+    uint32_t m_used[(s_num_slots + 31) / 32]{};
+    size_t m_size{0};
+};
+
+// open addressing map for wider ids, linear probing over a power of two sized slot array
+// erased slots are only marked, so erasing never moves other entries and never invalidates iterators to them
+template <typename Key, typename Value>
+class HashedIdMap {
+    template <typename Map, typename Entry>
+    friend class IdMapIterator;
+
+   public:
+    typedef pair<Key, Value> value_type;
+    typedef IdMapIterator<HashedIdMap, value_type> iterator;
+    typedef IdMapIterator<const HashedIdMap, const value_type> const_iterator;
+
+    static constexpr size_t s_min_capacity = 16;
+
+    HashedIdMap() = default;
+    ~HashedIdMap() {
+        delete[] m_slots;
+    };
+
+    HashedIdMap(const HashedIdMap&) = delete;
+    HashedIdMap& operator=(const HashedIdMap&) = delete;
+
+    iterator begin() {
+        return {this, 0};
+    };
+
+    iterator end() {
+        return {this, m_capacity};
+    };
+
+    const_iterator begin() const {
+        return {this, 0};
+    };
+
+    const_iterator end() const {
+        return {this, m_capacity};
+    };
+
+    size_t size() const {
+        return m_size;
+    };
+
+    bool empty() const {
+        return m_size == 0;
+    };
+
+    iterator find(Key key) {
+        return {this, find_slot(key)};
+    };
+
+    const_iterator find(Key key) const {
+        return {this, find_slot(key)};
+    };
+
+    // NOTE: like unordered_map::at, a missing key is an error instead of a value shared by all missing keys
+    Value& at(Key key) {
+        size_t index = find_slot(key);
+        if (index == m_capacity) IAC_HANDLE_FATAL_EXCEPTION(IdMapMissingKeyException, "at() with a key which is not in the map");
+        return m_slots[index].entry.second;
+    };
+
+    const Value& at(Key key) const {
+        size_t index = find_slot(key);
+        if (index == m_capacity) IAC_HANDLE_FATAL_EXCEPTION(IdMapMissingKeyException, "at() with a key which is not in the map");
+        return m_slots[index].entry.second;
+    };
+
+    Value& operator[](Key key) {
+        size_t index = find_slot(key);
+        if (index != m_capacity) return m_slots[index].entry.second;
+
+        // NOTE: marked slots count towards the load, they are dropped when rehashing
+        if ((m_size + m_num_erased + 1) * 4 > m_capacity * 3)
+            rehash((m_size + 1) * 2 > m_capacity ? m_capacity * 2 : m_capacity);
+
+        for (index = hash(key);; index = (index + 1) & (m_capacity - 1)) {
+            if (m_slots[index].state == slot_state::USED) continue;
+
+            if (m_slots[index].state == slot_state::ERASED) m_num_erased--;
+            break;
+        }
+
+        m_slots[index].state = slot_state::USED;
+        m_slots[index].entry.first = key;
+        m_size++;
+
+        return m_slots[index].entry.second;
+    };
+
+    size_t erase(Key key) {
+        size_t index = find_slot(key);
+        if (index == m_capacity) return 0;
+
+        m_slots[index].state = slot_state::ERASED;
+        m_slots[index].entry.second = Value{};
+        m_size--;
+        m_num_erased++;
+        return 1;
+    };
+
+    void erase(const const_iterator& it) {
+        erase(it->first);
+    };
+
+   private:
+    enum class slot_state : uint8_t {
+        EMPTY,
+        USED,
+        ERASED
+    };
+
+    typedef struct slot {
+        slot_state state = slot_state::EMPTY;
+        value_type entry{};
+    } slot_t;
+
+    size_t hash(Key key) const {
+        // NOTE: fibonacci hashing spreads consecutive ids over the whole table
+        return ((uint32_t)key * 2654435769u) >> (32 - m_capacity_bits);
+    };
+
+    size_t find_slot(Key key) const {
+        if (m_capacity == 0) return m_capacity;
+
+        for (size_t index = hash(key);; index = (index + 1) & (m_capacity - 1)) {
+            if (m_slots[index].state == slot_state::EMPTY) return m_capacity;
+            if (m_slots[index].state == slot_state::USED && m_slots[index].entry.first == key) return index;
+        }
+    };
+
+    void rehash(size_t capacity) {
+        capacity = max_of(capacity, s_min_capacity);
+
+        slot_t* old_slots = m_slots;
+        size_t old_capacity = m_capacity;
+
+        m_slots = new slot_t[capacity];
+        m_capacity = capacity;
+        m_capacity_bits = 0;
+        while (((size_t)1 << m_capacity_bits) < capacity) m_capacity_bits++;
+
+        m_num_erased = 0;
+
+        for (size_t i = 0; i < old_capacity; i++) {
+            if (old_slots[i].state != slot_state::USED) continue;
+
+            size_t index = hash(old_slots[i].entry.first);
+            while (m_slots[index].state == slot_state::USED) index = (index + 1) & (m_capacity - 1);
+
+            m_slots[index].state = slot_state::USED;
+            m_slots[index].entry.first = old_slots[i].entry.first;
+            m_slots[index].entry.second = iac::move(old_slots[i].entry.second);
+        }
+
+        delete[] old_slots;
+    };
+
+    size_t next_used_slot(size_t index) const {
+        while (index < m_capacity && m_slots[index].state != slot_state::USED) index++;
+        return index;
+    };
+
+    value_type& slot_entry(size_t index) {
+        return m_slots[index].entry;
+    };
+
+    const value_type& slot_entry(size_t index) const {
+        return m_slots[index].entry;
+    };
+
+    slot_t* m_slots{nullptr};
+    size_t m_capacity{0};
+    size_t m_capacity_bits{0};
+    size_t m_size{0}, m_num_erased{0};
+};
+
+// set of 8 bit ids as a bitmap, iterates in ascending order
+template <typename Key>
+class IdBitset {
+   public:
+    static constexpr size_t s_num_ids = (size_t)numeric_limits<Key>::max() + 1;
+    static_assert(s_num_ids <= 256, "id bitsets are meant for 8 bit ids");
+
+    class const_iterator {
+       public:
+        const_iterator(const IdBitset* set, size_t index)
+            : m_set(set), m_index(set->next_id(index)){};
+
+        Key operator*() const {
+            return m_index;
+        };
+
+        const_iterator& operator++() {
+            m_index = m_set->next_id(m_index + 1);
+            return *this;
+        };
+
+        const_iterator operator++(int) {
+            const_iterator previous = *this;
+            ++*this;
+            return previous;
+        };
+
+        bool operator==(const const_iterator& other) const {
+            return m_index == other.m_index;
+        };
+
+        bool operator!=(const const_iterator& other) const {
+            return m_index != other.m_index;
+        };
+
+       private:
+        const IdBitset* m_set;
+        size_t m_index;
+    };
+
+    typedef const_iterator iterator;
+
+    const_iterator begin() const {
+        return {this, 0};
+    };
+
+    const_iterator end() const {
+        return {this, s_num_ids};
+    };
+
+    size_t size() const {
+        size_t size = 0;
+        for (auto word : m_bits) size += __builtin_popcount(word);
+        return size;
+    };
+
+    bool empty() const {
+        for (auto word : m_bits)
+            if (word != 0) return false;
+        return true;
+    };
+
+    const_iterator find(Key key) const {
+        return contains(key) ? const_iterator{this, key} : end();
+    };
+
+    bool contains(Key key) const {
+        return (m_bits[key / 32] >> (key % 32)) & 1u;
+    };
+
+    void insert(Key key) {
+        m_bits[key / 32] |= 1u << (key % 32);
+    };
+
+    size_t erase(Key key) {
+        if (!contains(key)) return 0;
+
+        m_bits[key / 32] &= ~(1u << (key % 32));
+        return 1;
+    };
+
+    void erase(const const_iterator& it) {
+        erase(*it);
+    };
+
+   private:
+    size_t next_id(size_t index) const {
+        while (index < s_num_ids) {
+            uint32_t word = m_bits[index / 32] >> (index % 32);
+            if (word != 0) return index + __builtin_ctz(word);
+
+            index = (index / 32 + 1) * 32;
+        }
+
+        return s_num_ids;
+    };
+
+    uint32_t m_bits[(s_num_ids + 31) / 32]{};
+};
+
+// sorted vector which keeps up to `N` entries inline and only allocates beyond that,
+// `KeyOf` extracts the key an entry is sorted by
+template <typename Entry, typename Key, typename KeyOf, size_t N>
+class InlineSortedVector {
+   public:
+    typedef const Entry* const_iterator;
+    typedef const_iterator iterator;
+
+    InlineSortedVector() = default;
+    ~InlineSortedVector() {
+        delete[] m_heap;
+    };
+
+    InlineSortedVector(const InlineSortedVector& other) {
+        *this = other;
+    };
+
+    InlineSortedVector& operator=(const InlineSortedVector& other) {
+        if (&other == this) return *this;
+
+        m_size = 0;
+        reserve(other.m_size);
+        for (size_t i = 0; i < other.m_size; i++) data()[i] = other.data()[i];
+        m_size = other.m_size;
+
+        return *this;
+    };
+
+    const_iterator begin() const {
+        return data();
+    };
+
+    const_iterator end() const {
+        return data() + m_size;
+    };
+
+    size_t size() const {
+        return m_size;
+    };
+
+    bool empty() const {
+        return m_size == 0;
+    };
+
+    const_iterator find(Key key) const {
+        const Entry* entry = lower_bound(key);
+        return entry != end() && KeyOf{}(*entry) == key ? entry : end();
+    };
+
+    // NOTE: like for std::set and std::map, an existing entry with the same key is kept
+    void insert(const Entry& entry) {
+        Entry* position = (Entry*)lower_bound(KeyOf{}(entry));
+        if (position != end() && KeyOf{}(*position) == KeyOf{}(entry)) return;
+
+        size_t index = position - data();
+        reserve(m_size + 1);
+
+        for (size_t i = m_size; i > index; i--) data()[i] = data()[i - 1];
+        data()[index] = entry;
+        m_size++;
+    };
+
+    size_t erase(Key key) {
+        const_iterator it = find(key);
+        if (it == end()) return 0;
+
+        erase(it);
+        return 1;
+    };
+
+    void erase(const_iterator it) {
+        for (size_t i = it - data(); i + 1 < m_size; i++) data()[i] = data()[i + 1];
+        m_size--;
+    };
+
+   private:
+    Entry* data() {
+        return m_heap != nullptr ? m_heap : m_inline;
+    };
+
+    const Entry* data() const {
+        return m_heap != nullptr ? m_heap : m_inline;
+    };
+
+    const Entry* lower_bound(Key key) const {
+        size_t low = 0, high = m_size;
+        while (low < high) {
+            size_t middle = (low + high) / 2;
+            if (KeyOf{}(data()[middle]) < key) low = middle + 1;
+            else high = middle;
+        }
+
+        return data() + low;
+    };
+
+    void reserve(size_t capacity) {
+        if (capacity <= m_capacity) return;
+
+        size_t new_capacity = max_of(capacity, m_capacity * 2);
+        Entry* heap = new Entry[new_capacity];
+        for (size_t i = 0; i < m_size; i++) heap[i] = data()[i];
+
+        delete[] m_heap;
+        m_heap = heap;
+        m_capacity = new_capacity;
+    };
+
+    Entry m_inline[N]{};
+    Entry* m_heap{nullptr};
+    size_t m_size{0};
+    size_t m_capacity{N};
+};
+
+template <typename Key>
+struct IdKeyOf {
+    Key operator()(Key key) const {
+        return key;
+    };
+};
+
+template <typename Key, typename Value>
+struct IdPairKeyOf {
+    Key operator()(const pair<Key, Value>& entry) const {
+        return entry.first;
+    };
+};
+
+template <typename Key, size_t N>
+using InlineIdSet = InlineSortedVector<Key, Key, IdKeyOf<Key>, N>;
+
+template <typename Key, typename Value, size_t N>
+using InlineIdMap = InlineSortedVector<pair<Key, Value>, Key, IdPairKeyOf<Key, Value>, N>;
+
+template <typename Key, typename Value>
+constexpr size_t DenseIdMap<Key, Value>::s_num_slots;
+
+template <typename Key, typename Value>
+constexpr size_t HashedIdMap<Key, Value>::s_min_capacity;
+
+template <typename Key>
+constexpr size_t IdBitset<Key>::s_num_ids;
+
+}  // namespace iac
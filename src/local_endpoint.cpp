@@ -2,108 +2,87 @@
 
 namespace iac {
 
-LocalEndpoint::~LocalEndpoint() {
-    for (auto& entry : m_handlers) {
-        switch (entry.second.type) {
-            case package_handler_type::BY_BUFFER:
-                delete entry.second.ptr.by_buffer;
-                break;
-            case package_handler_type::BY_READER:
-                delete entry.second.ptr.by_reader;
-                break;
-            case package_handler_type::BY_BUFFER_WITH_DATA:
-                delete entry.second.ptr.by_buffer_with_data;
-                break;
-            case package_handler_type::BY_READER_WITH_DATA:
-                delete entry.second.ptr.by_reader_with_data;
-                break;
+constexpr size_t LocalEndpoint::s_num_package_types;
 
-#ifndef IAC_USE_LWSTD
-            case package_handler_type::BY_FN_BUFFER:
-                delete entry.second.ptr.by_fn_buffer;
-                break;
-            case package_handler_type::BY_FN_READER:
-                delete entry.second.ptr.by_fn_reader;
-                break;
-#endif
-            default:
-                IAC_ASSERT_NOT_REACHED();
-        }
-    }
+LocalEndpoint::~LocalEndpoint() {
+    for (size_t type = 0; type < s_num_package_types; type++)
+        remove_package_handler(type);
 }
 
 void LocalEndpoint::add_package_handler(package_type_t for_type, package_handler_by_reader_t handler) {
-    m_handlers[for_type].type = package_handler_type::BY_READER;
-    m_handlers[for_type].ptr.by_reader = new package_handler_by_reader_t{handler};
+    set_package_handler(for_type, dispatch_by_reader).ptr.by_reader = handler;
 }
 
 void LocalEndpoint::add_package_handler(package_type_t for_type, package_handler_by_buffer_t handler) {
-    m_handlers[for_type].type = package_handler_type::BY_BUFFER;
-    m_handlers[for_type].ptr.by_buffer = new package_handler_by_buffer_t{handler};
+    set_package_handler(for_type, dispatch_by_buffer).ptr.by_buffer = handler;
 }
 
 void LocalEndpoint::add_package_handler(package_type_t for_type, package_handler_by_reader_with_data_t handler, void* data) {
-    m_handlers[for_type].type = package_handler_type::BY_READER_WITH_DATA;
-    m_handlers[for_type].data = data;
-    m_handlers[for_type].ptr.by_reader_with_data = new package_handler_by_reader_with_data_t{handler};
+    set_package_handler(for_type, dispatch_by_reader_with_data, data).ptr.by_reader_with_data = handler;
 }
 
 void LocalEndpoint::add_package_handler(package_type_t for_type, package_handler_by_buffer_with_data_t handler, void* data) {
-    m_handlers[for_type].type = package_handler_type::BY_BUFFER_WITH_DATA;
-    m_handlers[for_type].data = data;
-    m_handlers[for_type].ptr.by_buffer_with_data = new package_handler_by_buffer_with_data_t{handler};
+    set_package_handler(for_type, dispatch_by_buffer_with_data, data).ptr.by_buffer_with_data = handler;
 }
 
 #ifndef IAC_USE_LWSTD
 void LocalEndpoint::add_package_handler(package_type_t for_type, package_handler_fn_by_buffer_t handler) {
-    m_handlers[for_type].type = package_handler_type::BY_FN_BUFFER;
-    m_handlers[for_type].ptr.by_fn_buffer = new package_handler_fn_by_buffer_t{handler};
+    set_package_handler(for_type, dispatch_fn_by_buffer).ptr.by_fn_buffer = new package_handler_fn_by_buffer_t{move(handler)};
 }
 
 void LocalEndpoint::add_package_handler(package_type_t for_type, package_handler_fn_by_reader_t handler) {
-    m_handlers[for_type].type = package_handler_type::BY_FN_READER;
-    m_handlers[for_type].ptr.by_fn_reader = new package_handler_fn_by_reader_t{handler};
+    set_package_handler(for_type, dispatch_fn_by_reader).ptr.by_fn_reader = new package_handler_fn_by_reader_t{move(handler)};
 }
 #endif
 
 bool LocalEndpoint::remove_package_handler(package_type_t for_type) {
-    delete m_handlers[for_type].ptr.by_buffer;
-    return m_handlers.erase(for_type) != 0U;
-}
-
-bool LocalEndpoint::handle_package(const Package& package) const {
-    auto entry = m_handlers.find(package.type());
-    if (entry == m_handlers.end())
-        return false;
-
-    switch (entry->second.type) {
-        case package_handler_type::BY_BUFFER:
-            (*entry->second.ptr.by_buffer)(package);
-            break;
-        case package_handler_type::BY_READER:
-            (*entry->second.ptr.by_reader)(package, BufferReader(package.payload(), package.payload_size()));
-            break;
-        case package_handler_type::BY_BUFFER_WITH_DATA:
-            (*entry->second.ptr.by_buffer_with_data)(package, entry->second.data);
-            break;
-        case package_handler_type::BY_READER_WITH_DATA:
-            (*entry->second.ptr.by_reader_with_data)(package, BufferReader(package.payload(), package.payload_size()), entry->second.data);
-            break;
+    auto& handler = m_handlers[for_type];
+    if (handler.dispatcher == nullptr) return false;
 
+    // NOTE: only function objects are owned by the handler table
 #ifndef IAC_USE_LWSTD
-        case package_handler_type::BY_FN_BUFFER:
-            (*entry->second.ptr.by_fn_buffer)(package);
-            break;
-        case package_handler_type::BY_FN_READER:
-            (*entry->second.ptr.by_fn_reader)(package, BufferReader(package.payload(), package.payload_size()));
-            break;
+    if (handler.dispatcher == dispatch_fn_by_buffer) delete handler.ptr.by_fn_buffer;
+    if (handler.dispatcher == dispatch_fn_by_reader) delete handler.ptr.by_fn_reader;
 #endif
-        default:
-            IAC_HANDLE_FATAL_EXCEPTION(EndpointException, "package handler had invalid type");
-            return false;
-    }
 
+    handler = {};
     return true;
 }
 
+LocalEndpoint::package_handler_t& LocalEndpoint::set_package_handler(package_type_t for_type, package_dispatcher_t dispatcher, void* data) {
+    remove_package_handler(for_type);
+
+    auto& handler = m_handlers[for_type];
+    handler.dispatcher = dispatcher;
+    handler.data = data;
+
+    return handler;
+}
+
+void LocalEndpoint::dispatch_by_reader(const package_handler_t& handler, const Package& pkg) {
+    handler.ptr.by_reader(pkg, BufferReader(pkg.payload(), pkg.payload_size()));
+}
+
+void LocalEndpoint::dispatch_by_buffer(const package_handler_t& handler, const Package& pkg) {
+    handler.ptr.by_buffer(pkg);
+}
+
+void LocalEndpoint::dispatch_by_reader_with_data(const package_handler_t& handler, const Package& pkg) {
+    handler.ptr.by_reader_with_data(pkg, BufferReader(pkg.payload(), pkg.payload_size()), handler.data);
+}
+
+void LocalEndpoint::dispatch_by_buffer_with_data(const package_handler_t& handler, const Package& pkg) {
+    handler.ptr.by_buffer_with_data(pkg, handler.data);
+}
+
+#ifndef IAC_USE_LWSTD
+void LocalEndpoint::dispatch_fn_by_reader(const package_handler_t& handler, const Package& pkg) {
+    (*handler.ptr.by_fn_reader)(pkg, BufferReader(pkg.payload(), pkg.payload_size()));
+}
+
+void LocalEndpoint::dispatch_fn_by_buffer(const package_handler_t& handler, const Package& pkg) {
+    (*handler.ptr.by_fn_buffer)(pkg);
+}
+#endif
+
 }  // namespace iac
\ No newline at end of file
@@ -4,8 +4,8 @@
 #include "forward.hpp"
 #include "network_types.hpp"
 #include "package.hpp"
+#include "std_provider/limits.hpp"
 #include "std_provider/string.hpp"
-#include "std_provider/unordered_map.hpp"
 #include "std_provider/utility.hpp"
 
 #ifndef IAC_USE_LWSTD
@@ -20,20 +20,6 @@ class LocalEndpoint : public Endpoint {
     friend LocalNode;
 
    public:
-    enum class package_handler_type {
-        BY_READER,
-        BY_BUFFER,
-        BY_READER_WITH_DATA,
-        BY_BUFFER_WITH_DATA,
-
-#ifndef IAC_USE_LWSTD
-        BY_FN_READER,
-        BY_FN_BUFFER
-#endif
-    };
-
-    typedef package_handler_type package_handler_type_t;
-
     typedef void (*package_handler_by_buffer_t)(const Package& pkg);
     typedef void (*package_handler_by_reader_t)(const Package& pkg, BufferReader&& reader);
     typedef void (*package_handler_by_buffer_with_data_t)(const Package& pkg, void* data);
@@ -44,14 +30,20 @@ class LocalEndpoint : public Endpoint {
     typedef std::function<void(const Package& pkg, BufferReader&& reader)> package_handler_fn_by_reader_t;
 #endif
 
+    struct package_handler_t;
+
+    // NOTE: every handler is invoked through a dispatcher matching its signature,
+    //       an entry without dispatcher has no handler registered
+    typedef void (*package_dispatcher_t)(const package_handler_t& handler, const Package& pkg);
+
     typedef struct package_handler_t {
-        package_handler_type_t type;
+        package_dispatcher_t dispatcher{nullptr};
         void* data{nullptr};
         union {
-            package_handler_by_reader_t* by_reader = nullptr;
-            package_handler_by_buffer_t* by_buffer;
-            package_handler_by_reader_with_data_t* by_reader_with_data;
-            package_handler_by_buffer_with_data_t* by_buffer_with_data;
+            package_handler_by_reader_t by_reader = nullptr;
+            package_handler_by_buffer_t by_buffer;
+            package_handler_by_reader_with_data_t by_reader_with_data;
+            package_handler_by_buffer_with_data_t by_buffer_with_data;
 
 #ifndef IAC_USE_LWSTD
             package_handler_fn_by_reader_t* by_fn_reader;
@@ -60,6 +52,8 @@ class LocalEndpoint : public Endpoint {
         } ptr;
     } package_handler_t;
 
+    static constexpr size_t s_num_package_types = (size_t)numeric_limits<package_type_t>::max() + 1;
+
     LocalEndpoint(ep_id_t id, string&& name)
         : Endpoint(id, name) {
         set_local(true);
@@ -82,11 +76,71 @@ class LocalEndpoint : public Endpoint {
     void add_package_handler(package_type_t for_type, package_handler_fn_by_buffer_t handler);
 #endif
 
+    // NOTE: handlers known at compile time are called directly from their dispatcher, so they can be inlined
+    template <package_type_t Type, package_handler_by_reader_t Handler>
+    void add_package_handler() {
+        set_package_handler(Type, dispatch_static_by_reader<Handler>);
+    };
+
+    template <package_type_t Type, package_handler_by_buffer_t Handler>
+    void add_package_handler() {
+        set_package_handler(Type, dispatch_static_by_buffer<Handler>);
+    };
+
+    template <package_type_t Type, package_handler_by_reader_with_data_t Handler>
+    void add_package_handler(void* data) {
+        set_package_handler(Type, dispatch_static_by_reader_with_data<Handler>, data);
+    };
+
+    template <package_type_t Type, package_handler_by_buffer_with_data_t Handler>
+    void add_package_handler(void* data) {
+        set_package_handler(Type, dispatch_static_by_buffer_with_data<Handler>, data);
+    };
+
     bool remove_package_handler(package_type_t for_type);
 
    private:
-    bool handle_package(const Package& package) const;
+    bool handle_package(const Package& package) const {
+        const auto& handler = m_handlers[package.type()];
+        if (handler.dispatcher == nullptr) return false;
+
+        handler.dispatcher(handler, package);
+        return true;
+    };
+
+    package_handler_t& set_package_handler(package_type_t for_type, package_dispatcher_t dispatcher, void* data = nullptr);
+
+    static void dispatch_by_reader(const package_handler_t& handler, const Package& pkg);
+    static void dispatch_by_buffer(const package_handler_t& handler, const Package& pkg);
+    static void dispatch_by_reader_with_data(const package_handler_t& handler, const Package& pkg);
+    static void dispatch_by_buffer_with_data(const package_handler_t& handler, const Package& pkg);
+
+#ifndef IAC_USE_LWSTD
+    static void dispatch_fn_by_reader(const package_handler_t& handler, const Package& pkg);
+    static void dispatch_fn_by_buffer(const package_handler_t& handler, const Package& pkg);
+#endif
+
+    template <package_handler_by_reader_t Handler>
+    static void dispatch_static_by_reader(const package_handler_t&, const Package& pkg) {
+        Handler(pkg, BufferReader(pkg.payload(), pkg.payload_size()));
+    };
+
+    template <package_handler_by_buffer_t Handler>
+    static void dispatch_static_by_buffer(const package_handler_t&, const Package& pkg) {
+        Handler(pkg);
+    };
+
+    template <package_handler_by_reader_with_data_t Handler>
+    static void dispatch_static_by_reader_with_data(const package_handler_t& handler, const Package& pkg) {
+        Handler(pkg, BufferReader(pkg.payload(), pkg.payload_size()), handler.data);
+    };
+
+    template <package_handler_by_buffer_with_data_t Handler>
+    static void dispatch_static_by_buffer_with_data(const package_handler_t& handler, const Package& pkg) {
+        Handler(pkg, handler.data);
+    };
 
-    unordered_map<package_type_t, package_handler_t> m_handlers;
+    // NOTE: package types are 8 bit, so dispatch is a single lookup without hashing
+    package_handler_t m_handlers[s_num_package_types]{};
 };
 }  // namespace iac
\ No newline at end of file
@@ -1,14 +1,22 @@
 #include "local_node.hpp"
 
+#include <atomic>
+
 #include "exceptions.hpp"
 #include "network_types.hpp"
 
 namespace iac {
 
+// NOTE: tells apart nodes of the same process which were created within the same microsecond
+static std::atomic<uint16_t> s_num_created_nodes{0};
+
 LocalNode::LocalNode(route_timings_t timings)
     : Node(unset_id), m_default_route_timings(timings) {
     set_local(true);
 
+    // NOTE: the counter is spread over the epochs, so nodes created a few microseconds apart don't end up with the same one
+    m_reliable_epoch = (uint16_t)(timestamp::now().ts + s_num_created_nodes++ * 0x9e37u);
+
     if (m_default_route_timings.heartbeat_interval_ms < s_min_heartbeat_interval_ms)
         m_default_route_timings.heartbeat_interval_ms = s_min_heartbeat_interval_ms;
 
@@ -16,6 +24,12 @@ LocalNode::LocalNode(route_timings_t timings)
         m_default_route_timings.assume_dead_after_ms = s_min_assume_dead_time;
 };
 
+LocalNode::~LocalNode() {
+#ifdef IAC_HAS_EPOLL
+    if (m_epoll_fd != -1) ::close(m_epoll_fd);
+#endif
+}
+
 uint8_t LocalNode::get_tr_id() {
     for (uint8_t id = 0; id < numeric_limits<uint8_t>::max(); ++id) {
         if (m_used_tr_ids.find(id) == m_used_tr_ids.end()) {
@@ -33,6 +47,10 @@ bool LocalNode::pop_tr_id(uint8_t id) {
 }
 
 bool LocalNode::add_local_transport_route(LocalTransportRoute& route) {
+    return add_local_transport_route(route, false);
+}
+
+bool LocalNode::add_local_transport_route(LocalTransportRoute& route, bool adopt) {
     auto& timings = route.meta().timings;
 
     if (timings.heartbeat_interval_ms < s_min_heartbeat_interval_ms)
@@ -43,14 +61,119 @@ bool LocalNode::add_local_transport_route(LocalTransportRoute& route) {
     // node ids consist of a 2-byte int, the 8 msb are the node id
     // the other 8 bits represent a unique (in LocalNode) id
     static constexpr uint8_t shift_by = 8;
-    route.set_id((id() << shift_by) | get_tr_id());
+    route.meta().local_id = get_tr_id();
+    route.set_id((id() << shift_by) | route.meta().local_id);
     route.set_node1(id());
 
-    return m_network.add_route(ManagedNetworkEntry<TransportRoute>::create_and_bind(route));
+    // NOTE: a route which was used by another node before may still look scheduled
+    route.meta().timer = {};
+
+    const auto local_id = route.meta().local_id;
+
+    // NOTE: an adopted route is already deleted if adding it fails
+    if (m_network.add_route(adopt ? ManagedNetworkEntry<TransportRoute>::create_and_adopt(route) : ManagedNetworkEntry<TransportRoute>::create_and_bind(route)))
+        return true;
+
+    pop_tr_id(local_id);
+    return false;
 }
 
 bool LocalNode::remove_local_transport_route(LocalTransportRoute& route) {
-    return close_route(&route) && m_network.remove_route(route.id());
+#ifdef IAC_HAS_EPOLL
+    // NOTE: descriptors which outlive the route (e.g. listening sockets) must not report events for it
+    if (m_epoll_fd != -1 && route.meta().polled_fd != -1) {
+        epoll_ctl(m_epoll_fd, EPOLL_CTL_DEL, route.meta().polled_fd, nullptr);
+        route.meta().polled_fd = -1;
+    }
+#endif
+
+    if (!close_route(&route)) return false;
+
+    // NOTE: adopted routes are deleted together with their network entry
+    const auto local_id = route.meta().local_id;
+    if (!m_network.remove_route(route.id())) return false;
+
+    pop_tr_id(local_id);
+    return remove_unreachable_nodes();
+}
+
+bool LocalNode::add_connection_listener(ConnectionListener& listener) {
+    return m_connection_listeners.insert({&listener, -1}).second;
+}
+
+bool LocalNode::remove_connection_listener(ConnectionListener& listener) {
+    auto res = m_connection_listeners.find(&listener);
+    if (res == m_connection_listeners.end()) return false;
+
+#ifdef IAC_HAS_EPOLL
+    if (m_epoll_fd != -1 && res->second != -1)
+        epoll_ctl(m_epoll_fd, EPOLL_CTL_DEL, res->second, nullptr);
+#endif
+
+    m_connection_listeners.erase(res);
+    return true;
+}
+
+bool LocalNode::accept_routes() {
+    for (const auto& listener_entry : m_connection_listeners) {
+        Connection* connection;
+        while ((connection = listener_entry.first->accept()) != nullptr) {
+            // NOTE: peers above the route limit are turned away, instead of being left waiting in the listener
+            if (m_used_tr_ids.size() >= numeric_limits<uint8_t>::max()) {
+                iac_log_from_node(Logging::loglevels::warning, "no more available ids for transport-routes, dropping accepted connection\n");
+                delete connection;
+                continue;
+            }
+
+            auto* route = LocalTransportRoute::create_and_adopt(connection);
+            route->meta().timings = m_default_route_timings;
+            route->set_receive_window(m_default_receive_window);
+            route->set_transient(true);
+
+            if (!add_local_transport_route(*route, true)) return false;
+            iac_log_from_node(Logging::loglevels::network, "accepted route %d\n", route->id());
+        }
+    }
+
+    return true;
+}
+
+bool LocalNode::remove_closed_transient_routes() {
+    bool removed_route = true;
+
+    // NOTE: removing a route can remove other entries of the network, so the search starts over after every removal
+    while (removed_route) {
+        removed_route = false;
+
+        for (const auto& route_entry : m_network.route_mapping()) {
+            if (!route_entry.second->local()) continue;
+            auto* route = (LocalTransportRoute*)route_entry.second.element_ptr();
+
+            if (!route->transient() || route->state() != LocalTransportRoute::route_state::CLOSED) continue;
+
+            iac_log_from_node(Logging::loglevels::network, "removing closed route %d\n", route->id());
+            if (!remove_local_transport_route(*route)) return false;
+
+            removed_route = true;
+            break;
+        }
+    }
+
+    return true;
+}
+
+bool LocalNode::remove_unreachable_nodes() {
+    for (auto it = m_network.node_mapping().begin(); it != m_network.node_mapping().end();) {
+        const auto& node_entry = it->second.element();
+        const auto node_id = it->first;
+
+        it++;  // only the current node is erased, so the iterator stays valid
+
+        if (node_entry.local() || !node_entry.local_routes().empty()) continue;
+        if (!m_network.remove_node(node_id)) return false;
+    }
+
+    return true;
 }
 
 bool LocalNode::add_local_endpoint(LocalEndpoint& ep) {
@@ -67,7 +190,7 @@ bool LocalNode::remove_local_endpoint(LocalEndpoint& ep) {
     return m_network.remove_endpoint(ep.id());
 }
 
-pair<tr_id_t, uint8_t> LocalNode::best_local_route(const unordered_map<tr_id_t, uint8_t>& local_routes) {
+pair<tr_id_t, uint8_t> LocalNode::best_local_route(const Node::local_route_list_t& local_routes) {
     pair<tr_id_t, uint8_t> best_route = *local_routes.begin();
     for (const auto& route : local_routes)
         if (route.second < best_route.second)
@@ -82,6 +205,10 @@ bool LocalNode::update() {
         return false;
     }
 
+    if (!accept_routes()) return false;
+
+    advance_timers();
+
     for (auto it = m_network.route_mapping().begin(); it != m_network.route_mapping().end();) {
         if (!it->second->local()) {
             it++;
@@ -95,6 +222,33 @@ bool LocalNode::update() {
         if (!state_handling(route)) return false;
     }
 
+    if (!remove_closed_transient_routes()) return false;
+    if (!send_network_updates()) return false;
+    if (!send_reliable_updates()) return false;
+
+    return flush_now();
+}
+
+bool LocalNode::flush_now() {
+    for (const auto& route_entry : m_network.route_mapping()) {
+        if (!route_entry.second->local()) continue;
+
+        auto* route = (LocalTransportRoute*)route_entry.second.element_ptr();
+        if (!route->meta().flush_pending) continue;
+
+        route->meta().flush_pending = false;
+
+        if (!Package::write_batch(route))
+            iac_log_from_node(Logging::loglevels::debug, "route %d did not take batch frame\n", route->id());
+
+        if (!drain_outbound_queue(route)) return false;
+        route->connection().flush();
+    }
+
+    return true;
+}
+
+bool LocalNode::send_network_updates() {
     if (m_network.is_modified()) {
         m_network.reset_modified();
         for (const auto& route_entry : m_network.route_mapping()) {
@@ -109,32 +263,167 @@ bool LocalNode::update() {
 }
 
 bool LocalNode::read_from(LocalTransportRoute* route) {
-    for (size_t i = 0; i < s_num_package_reads_from_route_per_update && route->connection().available() > 0; i++) {
+    const bool connection_lost = !route->connection().prefetch() || route->meta().peer_hung_up;
+    route->meta().receive_stalled = false;
+
+    relay_held_packages(route);
+
+    // NOTE: packages which arrived before the connection was lost are still handled,
+    //       as are all packages of a batch frame which was started
+    for (size_t i = 0; (connection_lost || route->received_batch_left() > 0 || (i < s_num_package_reads_from_route_per_update && !route->holding_full())) &&
+                       (route->connection().available() > 0 || route->received_batch_left() > 0);
+         i++) {
+        if (route->received_batch_left() == 0 && forward_frame(route)) {
+            route->meta().last_package_in = m_now;
+            continue;
+        }
+
         Package package;
         if (package.read_from(route)) {
             if (!handle_package(package)) return false;
-            route->meta().last_package_in = timestamp::now();
+            route->meta().last_package_in = m_now;
         } else {
             break;
         }
     }
+
+    if (connection_lost) {
+        iac_log_from_node(Logging::loglevels::network, "route %d was closed by the other side\n", route->id());
+        if (!close_route(route)) return false;
+        route->state() = LocalTransportRoute::route_state::CLOSED;
+        return true;
+    }
+
+    if (route->state() == LocalTransportRoute::route_state::CONNECTED && route->credit_update_due())
+        return send_credit(route);
+
+    return true;
+}
+
+bool LocalNode::drain_outbound_queue(LocalTransportRoute* route) {
+    if (!route->drain_outbound_queue()) return false;
+
+    notify_unblocked(route);
+    return true;
+}
+
+void LocalNode::notify_unblocked(LocalTransportRoute* route) {
+    if (!route->take_unblocked()) return;
+
+    // NOTE: routes holding packages try to relay them again, and stall once more if their next route is still blocked
+    for (const auto& route_entry : m_network.route_mapping())
+        if (route_entry.second->local())
+            ((LocalTransportRoute*)route_entry.second.element_ptr())->meta().receive_stalled = false;
+
+    if (m_writable_handler != nullptr)
+        m_writable_handler(*this, m_writable_handler_data);
+}
+
+bool LocalNode::forward_frame(LocalTransportRoute* route) {
+    if (route->state() != LocalTransportRoute::route_state::CONNECTED) return false;
+
+    Package::frame_header_t header;
+    if (!Package::peek_frame_header(route, header)) return false;
+
+    // NOTE: batches and fragments are unpacked, all other frames for remote endpoints are relayed as they are
+    if ((header.metadata & (Package::s_batch_flag | Package::s_fragment_flag)) != 0 || header.to == reserved_endpoint_addresses::IAC) return false;
+    if (!m_network.endpoint_registered(header.to) || m_network.endpoint(header.to).local()) return false;
+
+    auto* next_route = route_to(header.to);
+    if (next_route == nullptr || next_route == route || header.frame_size > next_route->frame_size_limit()) return false;
+
+    if (next_route->state() == LocalTransportRoute::route_state::INITIALIZED || next_route->state() == LocalTransportRoute::route_state::CLOSED)
+        return false;
+
+    // NOTE: while the other side is limited by credit, frames which can't be relayed right away, or would overtake
+    //       held packages, are read as packages and held by relay_package()
+    if (route->receive_window() > 0 && (route->held_size() > 0 || !next_route->admit_write(false))) return false;
+
+    if (Package::forward_frame(route, next_route, header.frame_size, Package::priority_of(header.metadata, header.to), m_coalesce_output)) {
+        if (m_coalesce_output) next_route->meta().flush_pending = true;
+        next_route->meta().last_package_out = m_now;
+    } else {
+        iac_log_from_node(Logging::loglevels::debug, "could not relay package to %d, dropping package\n", header.to);
+    }
+
     return true;
 }
 
+void LocalNode::relay_package(const Package& package) {
+    auto* from_route = package.route();
+    auto* next_route = route_to(package.to());
+
+    // NOTE: held packages aren't counted as read, so the other side runs out of credit instead of them being dropped,
+    //       while the frames behind them are still read, so credit granted by the next route can't get stuck behind them
+    if (from_route->receive_window() > 0 && next_route != nullptr && next_route != from_route &&
+        (from_route->held_size() > 0 || !next_route->admit_write(false))) {
+        from_route->hold_received(held_size_of(package));
+        m_held_packages[from_route].push(package.retain());
+        from_route->meta().receive_stalled = true;
+        return;
+    }
+
+    if (!send_package(package))
+        iac_log_from_node(Logging::loglevels::debug, "could not relay package to %d, dropping package\n", package.to());
+}
+
+void LocalNode::relay_held_packages(LocalTransportRoute* route) {
+    if (route->held_size() == 0) return;
+
+    auto& held = m_held_packages[route];
+
+    while (!held.empty()) {
+        const auto& package = held.front();
+        auto* next_route = route_to(package.to());
+
+        if (next_route != nullptr && !next_route->admit_write(false)) {
+            route->meta().receive_stalled = true;
+            return;
+        }
+
+        // NOTE: packages whose next route is gone meanwhile are dropped like any other package without route
+        if (!send_package(package))
+            iac_log_from_node(Logging::loglevels::debug, "could not relay held package to %d, dropping package\n", package.to());
+
+        route->release_received(held_size_of(package));
+        held.pop();
+    }
+}
+
+LocalTransportRoute* LocalNode::route_to(ep_id_t to) const {
+    if (m_next_hops_modification_count != m_network.modification_count())
+        update_next_hops();
+
+    return m_next_hops[to];
+}
+
+void LocalNode::update_next_hops() const {
+    for (auto& next_hop : m_next_hops)
+        next_hop = nullptr;
+
+    for (const auto& ep_entry : m_network.endpoint_mapping()) {
+        const auto node_id = ep_entry.second->node();
+        if (!m_network.node_registered(node_id)) continue;
+
+        const auto& available_routes = m_network.node(node_id).local_routes();
+        if (available_routes.empty()) continue;
+
+        m_next_hops[ep_entry.first] = (LocalTransportRoute*)&m_network.route(best_local_route(available_routes).first);
+    }
+
+    m_next_hops_modification_count = m_network.modification_count();
+}
+
 bool LocalNode::send_package(const Package& package) {
     if (!m_network.endpoint_registered(package.to())) {
         iac_log_from_node(Logging::loglevels::error, "asked to send package for unregistered endpoint %d, dropping package\n", package.to());
         return false;
     }
 
-    const auto& ep = m_network.endpoint(package.to());
-
-    const auto& available_routes = m_network.node(ep.node()).local_routes();
-    if (available_routes.empty())
+    auto* route = route_to(package.to());
+    if (route == nullptr)
         return false;
 
-    auto route = (LocalTransportRoute*)&m_network.route(best_local_route(available_routes).first);
-
     return send_package(package, route);
 }
 
@@ -144,8 +433,15 @@ bool LocalNode::send_package(const Package& package, LocalTransportRoute* route)
         return false;
     }
 
-    route->meta().last_package_out = timestamp::now();
-    return package.send_over(route);
+    if (!package.send_over(route, m_coalesce_output)) {
+        iac_log_from_node(Logging::loglevels::debug, "route %d would block, rejecting package with type %d to %d\n", route->id(), package.type(), package.to());
+        return false;
+    }
+
+    if (m_coalesce_output) route->meta().flush_pending = true;
+
+    route->meta().last_package_out = current_time();
+    return true;
 }
 
 }  // namespace iac
\ No newline at end of file
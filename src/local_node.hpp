@@ -5,6 +5,8 @@
 #include <sstream>
 #include <utility>
 
+#include "clock.hpp"
+#include "connection_types/connection_listener.hpp"
 #include "exceptions.hpp"
 #include "forward.hpp"
 #include "local_endpoint.hpp"
@@ -13,12 +15,21 @@
 #include "network.hpp"
 #include "network_types.hpp"
 #include "package.hpp"
+#include "reliable_stream.hpp"
 #include "std_provider/printf.hpp"
+#include "std_provider/queue.hpp"
 #include "std_provider/string.hpp"
 #include "std_provider/unordered_map.hpp"
 #include "std_provider/unordered_set.hpp"
 #include "std_provider/utility.hpp"
 #include "std_provider/vector.hpp"
+#include "timer_wheel.hpp"
+
+#if defined(__linux__) && !defined(ARDUINO)
+#    define IAC_HAS_EPOLL
+#    include <sys/epoll.h>
+#    include <unistd.h>
+#endif
 
 namespace iac {
 
@@ -35,7 +46,13 @@ IAC_MAKE_EXCEPTION(OutOfTrIdException);
 
 class LocalNode : public Node {
    public:
+    typedef void (*writable_handler_t)(LocalNode& node, void* data);
+
     LocalNode(route_timings_t route_timings = {});
+    ~LocalNode() override;
+
+    LocalNode(const LocalNode&) = delete;
+    LocalNode& operator=(const LocalNode&) = delete;
 
     bool endpoint_connected(ep_id_t address) const;
     bool endpoints_connected(const vector<ep_id_t>& addresses) const;
@@ -53,6 +70,23 @@ class LocalNode : public Node {
 
     bool update();
 
+#ifdef IAC_HAS_EPOLL
+    // sleeps until a route becomes readable, a route timer expires or `timeout_ms` passed (forever if negative),
+    // afterwards only the routes which need attention are handled
+    // NOTE: sleeping happens in real time, so with a virtual clock timers only expire once it was advanced
+    bool poll(int timeout_ms = -1);
+#endif
+
+    // all timestamps of the node are taken from `clock`, a steady clock is used as long as none is set
+    // NOTE: the clock has to outlive the node, nodes which share routes should share their clock as well
+    void set_clock(const Clock* clock) {
+        m_clock = clock;
+    };
+
+    const Clock* clock() const {
+        return m_clock;
+    };
+
     bool add_local_transport_route(LocalTransportRoute& route);
     bool remove_local_transport_route(LocalTransportRoute& route);
 
@@ -61,13 +95,53 @@ class LocalNode : public Node {
         return add_local_transport_route(package.route());
     };
 
+    // every connection accepted by `listener` is added as a transient route,
+    // which is removed again as soon as it is closed
+    bool add_connection_listener(ConnectionListener& listener);
+    bool remove_connection_listener(ConnectionListener& listener);
+
     bool add_local_endpoint(LocalEndpoint& ep);
     bool remove_local_endpoint(LocalEndpoint& ep);
 
-    bool send(Endpoint& from, ep_id_t to, package_type_t type, const BufferWriter& buffer, Package::buffer_management_t buffer_management = Package::buffer_management::IN_PLACE);
-    bool send(Endpoint& from, ep_id_t to, package_type_t type, const uint8_t* buffer, size_t buffer_length, Package::buffer_management_t buffer_management = Package::buffer_management::IN_PLACE);
-    bool send(ep_id_t from, ep_id_t to, package_type_t type, const BufferWriter& buffer, Package::buffer_management_t buffer_management = Package::buffer_management::IN_PLACE);
-    bool send(ep_id_t from, ep_id_t to, package_type_t type, const uint8_t* buffer, size_t buffer_length, Package::buffer_management_t buffer_management = Package::buffer_management::IN_PLACE);
+    // packages are queued on their routes according to `priority`, and are relayed with it as well
+    bool send(Endpoint& from, ep_id_t to, package_type_t type, const BufferWriter& buffer, Package::buffer_management_t buffer_management = Package::buffer_management::IN_PLACE, package_priority_t priority = package_priority::INTERACTIVE);
+    bool send(Endpoint& from, ep_id_t to, package_type_t type, const uint8_t* buffer, size_t buffer_length, Package::buffer_management_t buffer_management = Package::buffer_management::IN_PLACE, package_priority_t priority = package_priority::INTERACTIVE);
+    bool send(ep_id_t from, ep_id_t to, package_type_t type, const BufferWriter& buffer, Package::buffer_management_t buffer_management = Package::buffer_management::IN_PLACE, package_priority_t priority = package_priority::INTERACTIVE);
+    bool send(ep_id_t from, ep_id_t to, package_type_t type, const uint8_t* buffer, size_t buffer_length, Package::buffer_management_t buffer_management = Package::buffer_management::IN_PLACE, package_priority_t priority = package_priority::INTERACTIVE);
+
+    // false while the route to `to` queues more than its high watermark, sends to it are rejected until it drained
+    bool writable(ep_id_t to) const;
+
+    // packages of `type` sent by this node are numbered and kept until the receiving node acknowledged them,
+    // until then they are sent again whenever their retransmit timeout passed
+    // the receiving node hands every one of them to its endpoint once, but not necessarily in order
+    // NOTE: sends are rejected while a full window of packages to the same endpoint is unacknowledged
+    void set_reliable_delivery(package_type_t type, bool enabled);
+    bool reliable_delivery(package_type_t type) const;
+
+    // receive window of the routes accepted from connection listeners, see LocalTransportRoute::set_receive_window()
+    void set_default_receive_window(size_t window) {
+        m_default_receive_window = window;
+    };
+
+    // called whenever a route which rejected a send drained to half its high watermark and has credit again
+    void set_writable_handler(writable_handler_t handler, void* data = nullptr) {
+        m_writable_handler = handler;
+        m_writable_handler_data = data;
+    };
+
+    // while enabled, sends only append to the output of their route, which is written and flushed
+    // once at the end of update() / poll() or by flush_now()
+    void set_output_coalescing(bool enabled) {
+        m_coalesce_output = enabled;
+    };
+
+    bool output_coalescing() const {
+        return m_coalesce_output;
+    };
+
+    // writes and flushes all coalesced output right away
+    bool flush_now();
 
     const Network& network() const {
         return m_network;
@@ -77,13 +151,56 @@ class LocalNode : public Node {
     static constexpr uint16_t s_min_heartbeat_interval_ms = 100;
     static constexpr uint16_t s_min_assume_dead_time = s_min_heartbeat_interval_ms * 3;
     static constexpr uint8_t s_num_package_reads_from_route_per_update = 5;
+    static constexpr uint8_t s_num_fragments_to_route_per_update = 8;
+    static constexpr uint16_t s_reliable_retransmit_timeout_ms = 100;
+    static constexpr uint8_t s_max_reliable_transmissions = 8;
+
+#ifdef IAC_HAS_EPOLL
+    static constexpr int s_max_poll_events = 32;
+
+    int m_epoll_fd{-1};
+#endif
 
     route_timings_t m_default_route_timings;
+    size_t m_default_receive_window{0};
 
     Network m_network{};
 
+    const Clock* m_clock{nullptr};
+
+    // NOTE: time of the current update, read once instead of for every route and package
+    timestamp m_now{0};
+    TimerWheel m_timers;
+
     unordered_set<uint8_t> m_used_tr_ids;
 
+    // NOTE: route with the fewest hops towards every endpoint, rebuilt once the network was modified
+    mutable LocalTransportRoute* m_next_hops[numeric_limits<ep_id_t>::max() + 1]{};
+    mutable uint32_t m_next_hops_modification_count{0};
+
+    bool m_coalesce_output{false};
+
+    // NOTE: packages read from a flow controlled route, which wait in order until the route they are relayed over takes them
+    unordered_map<LocalTransportRoute*, queue<Package>> m_held_packages;
+
+    // NOTE: streams are kept per pair of local and remote endpoint, so their sequences continue after idle periods
+    IdBitset<package_type_t> m_reliable_types;
+    unordered_map<uint16_t, ReliableSender> m_reliable_senders;
+    unordered_map<uint16_t, ReliableReceiver> m_reliable_receivers;
+    // NOTE: differs between runs of a node, so receivers restart the streams of a node which was restarted
+    uint16_t m_reliable_epoch{0};
+
+    writable_handler_t m_writable_handler{nullptr};
+    void* m_writable_handler_data{nullptr};
+
+    // NOTE: maps every listener to the descriptor it is polled with, -1 if it is not polled
+    unordered_map<ConnectionListener*, int> m_connection_listeners;
+
+    bool add_local_transport_route(LocalTransportRoute& route, bool adopt);
+    bool accept_routes();
+    bool remove_closed_transient_routes();
+    bool remove_unreachable_nodes();
+
     bool send_package(const Package& package);
     bool send_package(const Package& package, LocalTransportRoute* route);
     bool handle_package(const Package& package);
@@ -92,23 +209,68 @@ class LocalNode : public Node {
     bool handle_heartbeat(const Package& package);
     bool handle_ack(const Package& package);
     bool handle_network_update(const Package& package);
+    bool handle_credit(const Package& package);
 
     bool read_from(LocalTransportRoute* route);
+    bool drain_outbound_queue(LocalTransportRoute* route);
+    // calls the writable handler once a route which rejected a write can take more, and resumes reading stalled routes
+    void notify_unblocked(LocalTransportRoute* route);
+    // relays the next frame of `route` without decoding it, false if it has to be read as a package
+    bool forward_frame(LocalTransportRoute* route);
+    // relays a package for another node, it is held instead while the route it arrived on is flow controlled
+    // and the next route can't take it, or other packages of the route are held already
+    void relay_package(const Package& package);
+    // relays the held packages of `route` in order, until one has to wait once more
+    void relay_held_packages(LocalTransportRoute* route);
+    LocalTransportRoute* route_to(ep_id_t to) const;
+    void update_next_hops() const;
+
+    timestamp current_time() const {
+        return m_clock != nullptr ? m_clock->now() : timestamp::now();
+    };
 
+    void advance_timers();
     bool state_handling(LocalTransportRoute* route);
+    void schedule_route_timer(LocalTransportRoute* route);
+    bool send_network_updates();
+
+    bool send_reliable(const Package& package);
+    void transmit_reliable(ReliableSender& sender, uint16_t sequence, timestamp now);
+    void schedule_retransmission(ReliableSender& sender, const ReliableSender::entry_t& entry);
+    bool handle_reliable_ack(const Package& package);
+    // sends the pending acks and the packages whose retransmit timeout passed
+    bool send_reliable_updates();
+
+    static size_t retransmit_timeout(uint8_t num_transmissions);
+
+    // NOTE: never more than was counted when reading the package, headers of batch items and fragments are left out
+    static size_t held_size_of(const Package& package) {
+        return Package::s_info_header_size + package.payload_size();
+    };
+
+    static uint16_t reliable_stream_key(ep_id_t local, ep_id_t remote) {
+        return (local << 8) | remote;
+    };
+
+#ifdef IAC_HAS_EPOLL
+    void update_poll_registrations();
+    size_t time_until_due(LocalTransportRoute* route, timestamp now);
+#endif
 
     bool open_route(LocalTransportRoute* route);
     bool close_route(LocalTransportRoute* route);
+    void send_fragments(LocalTransportRoute* route);
 
     bool send_connect(LocalTransportRoute* route);
     bool send_heartbeat(LocalTransportRoute* route);
     bool send_ack(LocalTransportRoute* route);
     bool send_network_update(LocalTransportRoute* route);
+    bool send_credit(LocalTransportRoute* route);
 
     uint8_t get_tr_id();
     bool pop_tr_id(uint8_t id);
 
-    static pair<tr_id_t, uint8_t> best_local_route(const unordered_map<tr_id_t, uint8_t>& local_routes);
+    static pair<tr_id_t, uint8_t> best_local_route(const Node::local_route_list_t& local_routes);
 };
 
 }  // namespace iac
\ No newline at end of file
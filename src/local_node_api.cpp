@@ -2,23 +2,32 @@
 
 namespace iac {
 
-bool LocalNode::send(Endpoint& from, ep_id_t to, package_type_t type, const uint8_t* buffer, size_t buffer_length, Package::buffer_management_t buffer_management) {
-    return send(from.id(), to, type, buffer, buffer_length, buffer_management);
+bool LocalNode::send(Endpoint& from, ep_id_t to, package_type_t type, const uint8_t* buffer, size_t buffer_length, Package::buffer_management_t buffer_management, package_priority_t priority) {
+    return send(from.id(), to, type, buffer, buffer_length, buffer_management, priority);
 }
 
-bool LocalNode::send(Endpoint& from, ep_id_t to, package_type_t type, const BufferWriter& buffer, Package::buffer_management_t buffer_management) {
-    return send(from, to, type, buffer.buffer(), buffer.size(), buffer_management);
+bool LocalNode::send(Endpoint& from, ep_id_t to, package_type_t type, const BufferWriter& buffer, Package::buffer_management_t buffer_management, package_priority_t priority) {
+    return send(from, to, type, buffer.buffer(), buffer.size(), buffer_management, priority);
 }
 
-bool LocalNode::send(ep_id_t from, ep_id_t to, package_type_t type, const BufferWriter& buffer, Package::buffer_management_t buffer_management) {
-    return send(from, to, type, buffer.buffer(), buffer.size(), buffer_management);
+bool LocalNode::send(ep_id_t from, ep_id_t to, package_type_t type, const BufferWriter& buffer, Package::buffer_management_t buffer_management, package_priority_t priority) {
+    return send(from, to, type, buffer.buffer(), buffer.size(), buffer_management, priority);
 }
 
-bool LocalNode::send(ep_id_t from, ep_id_t to, package_type_t type, const uint8_t* buffer, size_t buffer_length, Package::buffer_management_t buffer_management) {
+bool LocalNode::send(ep_id_t from, ep_id_t to, package_type_t type, const uint8_t* buffer, size_t buffer_length, Package::buffer_management_t buffer_management, package_priority_t priority) {
     Package package{from, to, type, buffer, buffer_length, buffer_management};
+    package.set_priority(priority);
+
+    if (m_reliable_types.contains(type)) return send_reliable(package);
+
     return send_package(package);
 }
 
+bool LocalNode::writable(ep_id_t to) const {
+    auto* route = route_to(to);
+    return route != nullptr && route->writable();
+}
+
 bool LocalNode::endpoint_connected(ep_id_t address) const {
     return m_network.endpoint_registered(address);
 }
@@ -17,6 +17,14 @@ bool LocalNode::handle_package(const Package& package) {
             return false;
         }
 
+        // NOTE: on stream transports the ack of the other side can be read along with its connect, before our own ack
+        //       was sent. The other side only acks again after a heartbeat interval, so our ack is sent right away
+        //       and the handshake completes with this ack instead of stalling the update
+        if (package.type() == reserved_package_types::ACK && package.route()->state() == LocalTransportRoute::route_state::SEND_ACK) {
+            if (!send_ack(package.route())) return false;
+            package.route()->state() = LocalTransportRoute::route_state::WAIT_ACK;
+        }
+
         if (package.type() == reserved_package_types::ACK && package.route()->state() == LocalTransportRoute::route_state::WAIT_ACK) {
             if (handle_ack(package)) {
                 package.route()->state() = LocalTransportRoute::route_state::CONNECTED;
@@ -26,6 +34,21 @@ bool LocalNode::handle_package(const Package& package) {
             return false;
         }
 
+        // NOTE: on lossy connections our connect can get lost, while the one of the other side arrived,
+        //       the ack is sent along, so two sides which both wait for an ack can't keep answering each other
+        if (package.type() == reserved_package_types::CONNECT &&
+            (package.route()->state() == LocalTransportRoute::route_state::SEND_ACK || package.route()->state() == LocalTransportRoute::route_state::WAIT_ACK)) {
+            return send_connect(package.route()) && send_ack(package.route());
+        }
+
+        // NOTE: the other side only sends these once it is connected, so it received our ack even if its own ack got lost
+        if ((package.type() == reserved_package_types::NETWORK_UPDATE || package.type() == reserved_package_types::HEARTBEAT ||
+             package.type() == reserved_package_types::CREDIT) &&
+            package.route()->state() == LocalTransportRoute::route_state::WAIT_ACK) {
+            package.route()->state() = LocalTransportRoute::route_state::CONNECTED;
+            m_network.set_modified();  // force a send of network_update
+        }
+
         if (package.route()->state() == LocalTransportRoute::route_state::CONNECTED) {
             if (package.type() == reserved_package_types::NETWORK_UPDATE) {
                 return handle_network_update(package);
@@ -34,6 +57,10 @@ bool LocalNode::handle_package(const Package& package) {
             if (package.type() == reserved_package_types::HEARTBEAT) {
                 return handle_heartbeat(package);
             }
+
+            if (package.type() == reserved_package_types::CREDIT) {
+                return handle_credit(package);
+            }
         }
 
         iac_log_from_node(Logging::loglevels::warning, "dropping package for IAC; route_id: %d; type: %d\n", package.route()->id(), package.type());
@@ -46,10 +73,21 @@ bool LocalNode::handle_package(const Package& package) {
 
     const auto& ep = m_network.endpoint(package.to());
 
-    if (ep.local())
+    if (ep.local()) {
+        if (package.m_metadata & Package::s_reliable_ack_flag)
+            return handle_reliable_ack(package);
+
+        // NOTE: duplicates of reliably delivered packages are only acknowledged again
+        if ((package.m_metadata & Package::s_reliable_flag) &&
+            !m_reliable_receivers[reliable_stream_key(package.to(), package.from())].accept(package.m_reliable.sequence, package.m_reliable.base, package.m_reliable.epoch))
+            return true;
+
         return ((const LocalEndpoint&)ep).handle_package(package);
+    }
 
-    return send_package(package);
+    // NOTE: a relayed package which can't be sent is no reason to stop reading
+    relay_package(package);
+    return true;
 }
 
 bool LocalNode::handle_connect(const Package& package) {
@@ -61,6 +99,11 @@ bool LocalNode::handle_connect(const Package& package) {
     package.route()->meta().timings.heartbeat_interval_ms = max_of(reader.num<uint16_t>(), package.route()->meta().timings.heartbeat_interval_ms);
     package.route()->meta().timings.assume_dead_after_ms = max_of(reader.num<uint16_t>(), package.route()->meta().timings.assume_dead_after_ms);
 
+    // NOTE: nodes which don't announce a frame size accept any
+    package.route()->meta().peer_max_frame_size = reader ? reader.num<uint16_t>() : 0;
+    // NOTE: nodes which don't announce a receive window aren't sent credit limited
+    package.route()->set_send_window(reader ? reader.num<uint32_t>() : 0);
+
     IAC_LOG_PACKAGE_RECEIVE_WITH_INFO(Logging::loglevels::network, "connect", "from %d", sender_id);
 
     if (!m_network.node_registered(sender_id)) {
@@ -123,11 +166,29 @@ bool LocalNode::handle_connect(const Package& package) {
 }
 
 bool LocalNode::handle_heartbeat(const Package& package) {
-    auto now = timestamp::now();
+    auto now = current_time();
 
     IAC_LOG_PACKAGE_RECEIVE_WITH_INFO(Logging::loglevels::verbose, "heartbeat", "with timing: last_out: %d; last_in:%d",
-                                      now - package.route()->meta().last_package_in,
-                                      now - package.route()->meta().last_package_out);
+                                      now.ms_since(package.route()->meta().last_package_in),
+                                      now.ms_since(package.route()->meta().last_package_out));
+
+    BufferReader reader{package.payload(), package.payload_size()};
+    if (!reader) return true;
+
+    package.route()->grant_send_credit(reader.num<uint32_t>());
+
+    notify_unblocked(package.route());
+    return true;
+}
+
+bool LocalNode::handle_credit(const Package& package) {
+    BufferReader reader{package.payload(), package.payload_size()};
+
+    IAC_LOG_PACKAGE_RECEIVE(Logging::loglevels::verbose, "credit");
+
+    package.route()->grant_send_credit(reader.num<uint32_t>());
+
+    notify_unblocked(package.route());
     return true;
 }
 
@@ -0,0 +1,212 @@
+#include "local_node.hpp"
+
+#ifdef IAC_HAS_EPOLL
+
+#    include <cerrno>
+
+namespace iac {
+
+constexpr int LocalNode::s_max_poll_events;
+
+bool LocalNode::poll(int timeout_ms) {
+    if (m_network.endpoint_mapping().empty()) {
+        IAC_HANDLE_EXCEPTION(NoRegisteredEndpointsException, "polling node with no endpoints");
+        return false;
+    }
+
+    if (m_epoll_fd == -1 && (m_epoll_fd = epoll_create1(EPOLL_CLOEXEC)) < 0) {
+        iac_log_from_node(Logging::loglevels::error, "epoll_create1() failed %d - %s, falling back to update\n", errno, strerror(errno));
+        m_epoll_fd = -1;
+        return update();
+    }
+
+    update_poll_registrations();
+
+    auto now = current_time();
+    size_t wait_ms = timeout_ms < 0 ? numeric_limits<int>::max() : timeout_ms;
+
+    if (m_network.is_modified()) wait_ms = 0;
+
+    for (const auto& route_entry : m_network.route_mapping()) {
+        if (wait_ms == 0) break;
+        if (!route_entry.second->local()) continue;
+
+        auto* route = (LocalTransportRoute*)route_entry.second.element_ptr();
+        wait_ms = min_of(wait_ms, time_until_due(route, now));
+    }
+
+    for (const auto& sender_entry : m_reliable_senders) {
+        if (wait_ms == 0) break;
+
+        const auto& sender = sender_entry.second;
+        if (sender.empty()) continue;
+
+        // NOTE: an unscheduled timer of a window which is not empty expired already
+        wait_ms = sender.timer().scheduled() ? min_of(wait_ms, sender.timer().deadline().until_more_than_n_in_past(now, 0)) : 0;
+    }
+
+    epoll_event events[s_max_poll_events];
+    int num_events = epoll_wait(m_epoll_fd, events, s_max_poll_events, (int)wait_ms);
+
+    if (num_events < 0) {
+        if (errno != EINTR) {
+            iac_log_from_node(Logging::loglevels::error, "epoll_wait() failed %d - %s\n", errno, strerror(errno));
+            return false;
+        }
+        num_events = 0;
+    }
+
+    bool listener_ready = false;
+
+    // NOTE: listeners are registered without a route
+    for (int i = 0; i < num_events; ++i) {
+        if (events[i].data.ptr == nullptr) {
+            listener_ready = true;
+            continue;
+        }
+
+        auto& meta = ((LocalTransportRoute*)events[i].data.ptr)->meta();
+        meta.poll_ready = true;
+        if (events[i].events & (EPOLLRDHUP | EPOLLHUP)) meta.peer_hung_up = true;
+    }
+
+    if (listener_ready && !accept_routes()) return false;
+
+    advance_timers();
+    now = m_now;
+
+    for (auto it = m_network.route_mapping().begin(); it != m_network.route_mapping().end();) {
+        if (!it->second->local()) {
+            it++;
+            continue;
+        }
+
+        auto* route = (LocalTransportRoute*)(it->second.element_ptr());
+
+        it++;  // iterator might get invalidated in handle_connect_package, so we have to increment now;
+
+        if (!route->meta().poll_ready && time_until_due(route, now) > 0) continue;
+
+        route->meta().poll_ready = false;
+        if (!state_handling(route)) return false;
+    }
+
+    if (!remove_closed_transient_routes()) return false;
+    if (!send_network_updates()) return false;
+    if (!send_reliable_updates()) return false;
+
+    return flush_now();
+}
+
+void LocalNode::update_poll_registrations() {
+    // NOTE: descriptors are removed in a first pass, so a descriptor number which was closed by one route
+    //       and reused by another one can't be removed after it was registered again
+    for (const auto& route_entry : m_network.route_mapping()) {
+        if (!route_entry.second->local()) continue;
+        auto* route = (LocalTransportRoute*)route_entry.second.element_ptr();
+
+        if (route->meta().polled_fd != -1 && route->meta().polled_fd != route->connection().file_descriptor()) {
+            // NOTE: closed descriptors were already dropped by the kernel, so errors are expected here
+            epoll_ctl(m_epoll_fd, EPOLL_CTL_DEL, route->meta().polled_fd, nullptr);
+            route->meta().polled_fd = -1;
+        }
+    }
+
+    for (const auto& route_entry : m_network.route_mapping()) {
+        if (!route_entry.second->local()) continue;
+        auto* route = (LocalTransportRoute*)route_entry.second.element_ptr();
+
+        int fd = route->connection().file_descriptor();
+        if (fd == -1) continue;
+
+        // NOTE: a connection which is opened in the background signals completion by becoming writable
+        // NOTE: queued data is written as soon as the connection can take more, routes whose held packages fill their window
+        //       aren't read until some of them were relayed
+        uint32_t events = (route->holding_full() ? 0u : (uint32_t)EPOLLIN) | EPOLLRDHUP;
+        if (route->state() == LocalTransportRoute::route_state::CONNECTING || route->outbound_size() > 0) events |= EPOLLOUT;
+
+        if (fd == route->meta().polled_fd && events == route->meta().polled_events) continue;
+
+        epoll_event event{};
+        event.events = events;
+        event.data.ptr = route;
+
+        if (epoll_ctl(m_epoll_fd, fd == route->meta().polled_fd ? EPOLL_CTL_MOD : EPOLL_CTL_ADD, fd, &event) != 0) {
+            iac_log_from_node(Logging::loglevels::warning, "could not poll route %d: %d - %s\n", route->id(), errno, strerror(errno));
+            continue;
+        }
+
+        route->meta().polled_fd = fd;
+        route->meta().polled_events = events;
+    }
+
+    for (auto& listener_entry : m_connection_listeners) {
+        int fd = listener_entry.first->file_descriptor();
+        if (fd == -1 || fd == listener_entry.second) continue;
+
+        if (listener_entry.second != -1)
+            epoll_ctl(m_epoll_fd, EPOLL_CTL_DEL, listener_entry.second, nullptr);
+
+        epoll_event event{};
+        event.events = EPOLLIN;
+        event.data.ptr = nullptr;
+
+        listener_entry.second = -1;
+        if (epoll_ctl(m_epoll_fd, EPOLL_CTL_ADD, fd, &event) != 0) {
+            iac_log_from_node(Logging::loglevels::warning, "could not poll connection listener: %d - %s\n", errno, strerror(errno));
+            continue;
+        }
+
+        listener_entry.second = fd;
+    }
+}
+
+size_t LocalNode::time_until_due(LocalTransportRoute* route, timestamp now) {
+    static constexpr size_t never = numeric_limits<int>::max();
+
+    const auto& meta = route->meta();
+    const bool waitable = meta.polled_fd != -1;
+
+    // NOTE: data in user space or on connections without descriptor can't be waited on,
+    //       unless a partial package is waiting for more data
+    auto has_progress = [&](size_t available_size) {
+        return available_size > 0 && available_size >= meta.wait_for_available_size;
+    };
+
+    if (route->received_batch_left() > 0) return 0;
+    if (!meta.receive_stalled && route->held_size() > 0) return 0;
+    if (!route->holding_full() && has_progress(route->connection().buffered())) return 0;
+    if (!waitable && !route->holding_full() && has_progress(route->connection().available())) return 0;
+    if (!waitable && route->outbound_size() > 0) return 0;
+    if (meta.flush_pending) return 0;
+
+    switch (route->state()) {
+        case LocalTransportRoute::route_state::INITIALIZED:
+        case LocalTransportRoute::route_state::CLOSED:
+            // NOTE: descriptors of unopened routes (e.g. listening sockets) signal when opening can succeed,
+            //       but routes which are readable before being opened still need a first attempt
+            if (waitable && meta.last_open_attempt.ts != 0) return never;
+            return meta.last_open_attempt.until_more_than_n_in_past(now, meta.timings.heartbeat_interval_ms);
+
+        case LocalTransportRoute::route_state::CONNECTING:
+            if (!waitable) return 0;
+            return meta.last_open_attempt.until_more_than_n_in_past(now, meta.timings.assume_dead_after_ms);
+
+        case LocalTransportRoute::route_state::SEND_CONNECT:
+        case LocalTransportRoute::route_state::SEND_ACK:
+            return 0;
+
+        case LocalTransportRoute::route_state::WAIT_CONNECT:
+        case LocalTransportRoute::route_state::WAIT_ACK:
+        case LocalTransportRoute::route_state::CONNECTED:
+            if (route->state() == LocalTransportRoute::route_state::CONNECTED && route->has_outgoing_transfers() && route->writable()) return 0;
+            return min_of(meta.last_package_out.until_more_than_n_in_past(now, meta.timings.heartbeat_interval_ms),
+                          meta.last_package_in.until_more_than_n_in_past(now, meta.timings.assume_dead_after_ms));
+    }
+
+    return 0;
+}
+
+}  // namespace iac
+
+#endif
@@ -0,0 +1,132 @@
+#include "local_node.hpp"
+
+namespace iac {
+
+constexpr uint16_t LocalNode::s_reliable_retransmit_timeout_ms;
+constexpr uint8_t LocalNode::s_max_reliable_transmissions;
+
+void LocalNode::set_reliable_delivery(package_type_t type, bool enabled) {
+    if (enabled)
+        m_reliable_types.insert(type);
+    else
+        m_reliable_types.erase(type);
+}
+
+bool LocalNode::reliable_delivery(package_type_t type) const {
+    return m_reliable_types.contains(type);
+}
+
+bool LocalNode::send_reliable(const Package& package) {
+    if (!m_network.endpoint_registered(package.to())) {
+        iac_log_from_node(Logging::loglevels::error, "asked to send package for unregistered endpoint %d, dropping package\n", package.to());
+        return false;
+    }
+
+    auto& sender = m_reliable_senders[reliable_stream_key(package.from(), package.to())];
+
+    if (sender.full()) {
+        iac_log_from_node(Logging::loglevels::debug, "too many unacknowledged packages to %d, rejecting package with type %d\n", package.to(), package.type());
+        return false;
+    }
+
+    const uint16_t sequence = sender.next_sequence();
+
+    auto& entry = sender.push(package);
+    entry.package.m_metadata |= Package::s_reliable_flag;
+    entry.package.m_reliable.sequence = sequence;
+    entry.package.m_reliable.epoch = m_reliable_epoch;
+
+    // NOTE: a package which can't be sent right away (e.g. because its route is closed) goes out with the retransmissions
+    transmit_reliable(sender, sequence, current_time());
+    return true;
+}
+
+void LocalNode::transmit_reliable(ReliableSender& sender, uint16_t sequence, timestamp now) {
+    auto& entry = sender.entry(sequence);
+
+    entry.package.m_reliable.base = sender.base();
+    entry.last_transmission = now;
+
+    if (send_package(entry.package)) entry.num_transmissions++;
+
+    schedule_retransmission(sender, entry);
+}
+
+void LocalNode::schedule_retransmission(ReliableSender& sender, const ReliableSender::entry_t& entry) {
+    const auto deadline = entry.last_transmission.more_than_n_later(retransmit_timeout(entry.num_transmissions));
+
+    if (!sender.timer().scheduled() || deadline < sender.timer().deadline())
+        m_timers.schedule(sender.timer(), deadline);
+}
+
+bool LocalNode::handle_reliable_ack(const Package& package) {
+    auto res = m_reliable_senders.find(reliable_stream_key(package.to(), package.from()));
+    if (res == m_reliable_senders.end()) return true;
+
+    // NOTE: acks for the packages of a previous run of this node don't cover the current sequences
+    if (package.m_reliable.epoch != m_reliable_epoch) return true;
+
+    auto& sender = res->second;
+    sender.acknowledge(package.m_reliable.sequence, package.m_reliable.received);
+
+    if (sender.empty()) m_timers.cancel(sender.timer());
+    return true;
+}
+
+bool LocalNode::send_reliable_updates() {
+    // NOTE: one ack per stream and update covers every package which arrived since the last one
+    for (auto& receiver_entry : m_reliable_receivers) {
+        auto& receiver = receiver_entry.second;
+        if (!receiver.ack_pending()) continue;
+
+        receiver.set_ack_pending(false);
+
+        Package ack{(ep_id_t)(receiver_entry.first >> 8), (ep_id_t)(receiver_entry.first & 0xff), 0, nullptr, 0};
+        ack.m_metadata = Package::s_reliable_ack_flag;
+        ack.set_priority(package_priority::CONTROL);
+        ack.m_reliable.sequence = receiver.next_expected();
+        ack.m_reliable.received = receiver.received();
+        ack.m_reliable.epoch = receiver.epoch();
+
+        // NOTE: a lost ack is sent again once the sender retransmits
+        if (!send_package(ack))
+            iac_log_from_node(Logging::loglevels::debug, "could not send ack to %d\n", ack.to());
+    }
+
+    for (auto& sender_entry : m_reliable_senders) {
+        auto& sender = sender_entry.second;
+
+        // NOTE: the timer expires with the earliest retransmission of the window
+        if (sender.empty() || sender.timer().scheduled()) continue;
+
+        for (uint16_t sequence = sender.base(); sequence != sender.next_sequence(); sequence++) {
+            auto& entry = sender.entry(sequence);
+            if (!entry.used) continue;
+
+            if (!entry.last_transmission.is_more_than_n_in_past(m_now, retransmit_timeout(entry.num_transmissions))) {
+                schedule_retransmission(sender, entry);
+                continue;
+            }
+
+            // NOTE: the receiver skips dropped packages once the base of the sender moved past them
+            if (entry.num_transmissions >= s_max_reliable_transmissions || !m_network.endpoint_registered(entry.package.to())) {
+                iac_log_from_node(Logging::loglevels::warning, "giving up on package %u with type %d to %d\n", sequence, entry.package.type(), entry.package.to());
+                sender.drop(sequence);
+                continue;
+            }
+
+            transmit_reliable(sender, sequence, m_now);
+        }
+    }
+
+    return true;
+}
+
+size_t LocalNode::retransmit_timeout(uint8_t num_transmissions) {
+    // NOTE: backs off exponentially on unresponsive receivers, up to eight times the initial timeout
+    static constexpr uint8_t max_backoff_shift = 3;
+
+    return (size_t)s_reliable_retransmit_timeout_ms << min_of(num_transmissions > 0 ? num_transmissions - 1 : 0, (int)max_backoff_shift);
+}
+
+}  // namespace iac
\ No newline at end of file
@@ -6,6 +6,11 @@ namespace iac {
 
 On init:        +-----------------+                 +-----------------+
                 | INITIALIZED     |                 | INITIALIZED     |
+                +-----------------+                 +-----------------+
+                         |                                   |
+                         V                                   V
+                +-----------------+                 +-----------------+
+                | (CONNECTING)    |                 | (CONNECTING)    |
                 +-----------------+                 +-----------------+
                          |                                   |
                          V                                   V
@@ -33,23 +38,61 @@ msg::connect |           V                                   V           | msg::
                 | CONNECTED       |                 | CONNECTED       |
                 +-----------------+                 +-----------------+
 
+
+CONNECTING is only entered while the connection finishes opening in the background.
+
 */
 
+void LocalNode::advance_timers() {
+    m_now = current_time();
+    m_timers.advance(m_now);
+}
+
 bool LocalNode::state_handling(LocalTransportRoute* route) {
     iac_log_from_node(Logging::loglevels::verbose, "state of route %d @ node %d is %d\n", route->id(), id(), route->state());
-    auto now = timestamp::now();
+    const auto now = m_now;
+
+    // NOTE: timeouts and heartbeats are only checked once the timer of the route expired (or was never scheduled)
+    const bool timer_expired = !route->meta().timer.scheduled();
 
-    if (route->state() != LocalTransportRoute::route_state::CLOSED &&
+    if (timer_expired &&
+        route->state() != LocalTransportRoute::route_state::CLOSED &&
         route->state() != LocalTransportRoute::route_state::INITIALIZED &&
+        route->state() != LocalTransportRoute::route_state::CONNECTING &&
         route->meta().last_package_in.is_more_than_n_in_past(now, route->meta().timings.assume_dead_after_ms)) {
         if (!close_route(route)) return false;
         route->state() = LocalTransportRoute::route_state::CLOSED;
     }
 
+    // NOTE: queued data goes out before anything new is written, coalesced output waits for the end of the update
+    if (route->outbound_size() > 0 && !route->meta().flush_pending &&
+        route->state() != LocalTransportRoute::route_state::CLOSED &&
+        route->state() != LocalTransportRoute::route_state::INITIALIZED &&
+        route->state() != LocalTransportRoute::route_state::CONNECTING) {
+        if (!drain_outbound_queue(route)) return false;
+    }
+
     switch (route->state()) {
         case LocalTransportRoute::route_state::INITIALIZED:
         case LocalTransportRoute::route_state::CLOSED:
-            if (!open_route(route)) return false;
+        case LocalTransportRoute::route_state::CONNECTING:
+            // NOTE: routes which can't be opened yet are retried on the next update, without stalling other routes
+            if (!open_route(route)) {
+                if (route->connection().open_pending()) {
+                    route->state() = LocalTransportRoute::route_state::CONNECTING;
+
+                    if (timer_expired && route->meta().last_open_attempt.is_more_than_n_in_past(now, route->meta().timings.assume_dead_after_ms)) {
+                        iac_log_from_node(Logging::loglevels::network, "opening route %d timed out\n", route->id());
+                        if (!close_route(route)) return false;
+                        route->state() = LocalTransportRoute::route_state::CLOSED;
+                    }
+                } else if (route->state() == LocalTransportRoute::route_state::CONNECTING) {
+                    route->state() = LocalTransportRoute::route_state::CLOSED;
+                }
+
+                schedule_route_timer(route);
+                return true;
+            }
             route->state() = LocalTransportRoute::route_state::SEND_CONNECT;
             // intentional fall-through
 
@@ -60,7 +103,7 @@ bool LocalNode::state_handling(LocalTransportRoute* route) {
 
         case LocalTransportRoute::route_state::WAIT_CONNECT:
             // NOTE: This loop will be broken when a CONNECT package from this route arrives
-            if (route->meta().last_package_out.is_more_than_n_in_past(now, route->meta().timings.heartbeat_interval_ms))
+            if (timer_expired && route->meta().last_package_out.is_more_than_n_in_past(now, route->meta().timings.heartbeat_interval_ms))
                 route->state() = LocalTransportRoute::route_state::SEND_CONNECT;
             break;
 
@@ -72,28 +115,86 @@ bool LocalNode::state_handling(LocalTransportRoute* route) {
 
         case LocalTransportRoute::route_state::WAIT_ACK:
             // NOTE: This loop will be broken when a ACK package from this route arrives
-            if (route->meta().last_package_out.is_more_than_n_in_past(now, route->meta().timings.heartbeat_interval_ms))
+            if (timer_expired && route->meta().last_package_out.is_more_than_n_in_past(now, route->meta().timings.heartbeat_interval_ms))
                 route->state() = LocalTransportRoute::route_state::SEND_ACK;
             break;
 
         case LocalTransportRoute::route_state::CONNECTED:
 
-            if (route->meta().last_package_out.is_more_than_n_in_past(now, route->meta().timings.heartbeat_interval_ms)) {
+            if (timer_expired && route->meta().last_package_out.is_more_than_n_in_past(now, route->meta().timings.heartbeat_interval_ms)) {
                 if (!send_heartbeat(route)) return false;
             }
 
+            // NOTE: the timer expires at least once per heartbeat interval, so transfers which lost a fragment free their slot
+            //       after a few intervals without any fragment
+            if (timer_expired) route->age_incoming_transfers();
+
+            send_fragments(route);
             break;
     }
 
     // NOTE: route should always be open at this point
     if (!read_from(route)) return false;
 
+    schedule_route_timer(route);
     return true;
 }
 
+void LocalNode::schedule_route_timer(LocalTransportRoute* route) {
+    auto& meta = route->meta();
+
+    // NOTE: packages only move the timeouts further out, so a timer which is still scheduled expires early enough
+    //       and is rescheduled once it did, instead of on every package
+    if (meta.timer.scheduled()) return;
+
+    switch (route->state()) {
+        case LocalTransportRoute::route_state::INITIALIZED:
+        case LocalTransportRoute::route_state::CLOSED:
+        case LocalTransportRoute::route_state::SEND_CONNECT:
+        case LocalTransportRoute::route_state::SEND_ACK:
+            // NOTE: these states are handled on every update anyway
+            return;
+
+        case LocalTransportRoute::route_state::CONNECTING:
+            m_timers.schedule(meta.timer, meta.last_open_attempt.more_than_n_later(meta.timings.assume_dead_after_ms));
+            return;
+
+        case LocalTransportRoute::route_state::WAIT_CONNECT:
+        case LocalTransportRoute::route_state::WAIT_ACK:
+        case LocalTransportRoute::route_state::CONNECTED:
+            m_timers.schedule(meta.timer, min_of(meta.last_package_out.more_than_n_later(meta.timings.heartbeat_interval_ms).ts,
+                                                 meta.last_package_in.more_than_n_later(meta.timings.assume_dead_after_ms).ts));
+            return;
+    }
+}
+
+void LocalNode::send_fragments(LocalTransportRoute* route) {
+    size_t num_fragments = 0;
+
+    // NOTE: a few fragments per update, so large transfers share the route with everything else
+    while (route->has_outgoing_transfers() && num_fragments < s_num_fragments_to_route_per_update && Package::write_fragment(route))
+        num_fragments++;
+
+    if (num_fragments == 0) return;
+
+    route->meta().last_package_out = m_now;
+
+    if (m_coalesce_output)
+        route->meta().flush_pending = true;
+    else
+        route->connection().flush();
+}
+
 bool LocalNode::open_route(LocalTransportRoute* route) {
+    const auto now = m_now;
+
+    // NOTE: a pending open keeps the time of its first attempt, so it can time out
+    if (route->state() != LocalTransportRoute::route_state::CONNECTING)
+        route->meta().last_open_attempt = now;
+
     if (route->connection().open()) {
-        auto now = timestamp::now();
+        // NOTE: a hang up reported while the connection was still being opened belongs to a failed attempt
+        route->meta().peer_hung_up = false;
         route->meta().last_package_in = now;
         route->meta().last_package_out = now;
         iac_log_from_node(Logging::loglevels::network, "opened route %d [%s]\n", route->id(), route->typestring().c_str());
@@ -105,6 +206,19 @@ bool LocalNode::open_route(LocalTransportRoute* route) {
 }
 
 bool LocalNode::close_route(LocalTransportRoute* route) {
+    m_timers.cancel(route->meta().timer);
+
+    // NOTE: a partially written package must not end up on the next connection
+    route->clear_outbound_queue();
+    route->meta().flush_pending = false;
+    route->set_received_batch(0, 0);
+    route->clear_incoming_transfers();
+    route->meta().peer_max_frame_size = 0;
+    route->meta().receive_stalled = false;
+    route->reset_flow_control();
+    m_held_packages.erase(route);
+    route->meta().peer_hung_up = false;
+
     if (route->connection().close()) {
         if (!(m_network.disconnect_route(route->id()) && route->reset())) {
             iac_log_from_node(Logging::loglevels::warning, "error disconnecting route %d [%s] \n", route->id(), route->typestring().c_str());
@@ -163,9 +277,14 @@ bool LocalNode::send_network_update(LocalTransportRoute* route) {
 }
 
 bool LocalNode::send_heartbeat(LocalTransportRoute* route) {
+    BufferWriter writer;
+
+    // NOTE: repeats the credit granted so far, in case a credit package got lost, heartbeats of routes without flow control stay empty
+    if (route->flow_controlled()) writer.num(route->take_credit_limit());
+
     Package package{reserved_endpoint_addresses::IAC,
                     reserved_endpoint_addresses::IAC,
-                    reserved_package_types::HEARTBEAT, nullptr, 0};
+                    reserved_package_types::HEARTBEAT, writer.buffer(), writer.size()};
 
     IAC_LOG_PACKAGE_SEND(Logging::loglevels::verbose, "heartbeat");
 
@@ -191,6 +310,9 @@ bool LocalNode::send_connect(LocalTransportRoute* route) {
     writer.num(route->meta().timings.heartbeat_interval_ms);
     writer.num(route->meta().timings.assume_dead_after_ms);
 
+    writer.num((uint16_t)route->max_frame_size());
+    writer.num(route->announce_receive_window());
+
     Package package{reserved_endpoint_addresses::IAC,
                     reserved_endpoint_addresses::IAC,
                     reserved_package_types::CONNECT, writer.buffer(), writer.size()};
@@ -200,4 +322,17 @@ bool LocalNode::send_connect(LocalTransportRoute* route) {
     return send_package(package, route);
 }
 
+bool LocalNode::send_credit(LocalTransportRoute* route) {
+    BufferWriter writer;
+    writer.num(route->take_credit_limit());
+
+    Package package{reserved_endpoint_addresses::IAC,
+                    reserved_endpoint_addresses::IAC,
+                    reserved_package_types::CREDIT, writer.buffer(), writer.size()};
+
+    IAC_LOG_PACKAGE_SEND(Logging::loglevels::verbose, "credit");
+
+    return send_package(package, route);
+}
+
 }  // namespace iac
\ No newline at end of file
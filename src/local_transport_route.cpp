@@ -2,9 +2,288 @@
 
 namespace iac {
 
+constexpr size_t LocalTransportRoute::s_default_high_watermark;
+constexpr size_t LocalTransportRoute::s_max_batch_size;
+constexpr size_t LocalTransportRoute::s_min_frame_size;
+constexpr size_t LocalTransportRoute::s_max_frame_size;
+constexpr size_t LocalTransportRoute::s_num_reassembly_slots;
+constexpr uint8_t LocalTransportRoute::s_max_transfer_idle_ticks;
+constexpr size_t LocalTransportRoute::s_num_priorities;
+constexpr uint8_t LocalTransportRoute::s_interactive_frames_per_bulk_frame;
+
 LocalTransportRoute::LocalTransportRoute(Connection& connection)
     : m_connection(&connection) {
     set_local(true);
 };
 
+LocalTransportRoute::~LocalTransportRoute() {
+    delete[] m_receive_buffer;
+    delete[] m_batch;
+
+    clear_outbound_queue();
+    for (auto& transfer : m_incoming_transfers)
+        delete[] transfer.payload;
+
+    if (m_owns_connection)
+        delete m_connection;
+}
+
+LocalTransportRoute* LocalTransportRoute::create_and_adopt(Connection* connection) {
+    auto* route = new LocalTransportRoute(*connection);
+    route->m_owns_connection = true;
+    return route;
+}
+
+uint8_t* LocalTransportRoute::receive_buffer(size_t min_size) {
+    if (m_receive_buffer_size < min_size) {
+        // NOTE: the buffer only holds the package currently being handled, so nothing needs to be copied over
+        delete[] m_receive_buffer;
+
+        m_receive_buffer_size = max_of(min_size, m_receive_buffer_size * 2);
+        m_receive_buffer = new uint8_t[m_receive_buffer_size];
+    }
+
+    return m_receive_buffer;
+}
+
+uint8_t* LocalTransportRoute::reserve_batch(size_t size, size_t max_size, package_priority_t priority) {
+    if (m_batch_size + size > min_of(max_size, s_max_batch_size)) return nullptr;
+
+    if (priority < m_batch_priority) m_batch_priority = priority;
+
+    if (m_batch == nullptr)
+        m_batch = new uint8_t[s_max_batch_size];
+
+    uint8_t* reserved = m_batch + m_batch_size;
+    m_batch_size += size;
+    return reserved;
+}
+
+const uint8_t* LocalTransportRoute::read_received_batch(size_t size) {
+    if (received_batch_left() < size) return nullptr;
+
+    const uint8_t* data = m_receive_buffer + m_received_batch_begin;
+    m_received_batch_begin += size;
+    return data;
+}
+
+void LocalTransportRoute::add_outgoing_transfer(ep_id_t from, ep_id_t to, package_type_t type, metadata_t metadata, const reliable_header_t& reliable,
+                                                const uint8_t* payload, payload_size_t payload_size) {
+    outgoing_transfer_t transfer{from, to, type, m_next_transfer_id++, metadata, reliable, new uint8_t[payload_size], payload_size, 0};
+    memcpy(transfer.payload, payload, payload_size);
+
+    if (m_outgoing_transfers.size() < s_num_reassembly_slots)
+        m_outgoing_transfers.push(transfer);
+    else
+        m_waiting_outgoing_transfers.push(transfer);
+}
+
+void LocalTransportRoute::rotate_outgoing_transfers() {
+    auto transfer = m_outgoing_transfers.front();
+    m_outgoing_transfers.pop();
+
+    if (transfer.offset < transfer.payload_size) {
+        m_outgoing_transfers.push(transfer);
+        return;
+    }
+
+    delete[] transfer.payload;
+
+    if (!m_waiting_outgoing_transfers.empty()) {
+        m_outgoing_transfers.push(m_waiting_outgoing_transfers.front());
+        m_waiting_outgoing_transfers.pop();
+    }
+}
+
+LocalTransportRoute::incoming_transfer_t* LocalTransportRoute::incoming_transfer(ep_id_t from, ep_id_t to, uint16_t id, payload_size_t payload_size, payload_size_t offset) {
+    incoming_transfer_t* free_slot = nullptr;
+
+    for (auto& transfer : m_incoming_transfers) {
+        if (transfer.used && transfer.from == from && transfer.to == to && transfer.id == id)
+            return transfer.payload_size == payload_size ? &transfer : nullptr;
+
+        // NOTE: prefers a free slot which doesn't need a new buffer, slots of transfers which lost a fragment count as free
+        const bool free = !transfer.used || transfer.idle_ticks >= s_max_transfer_idle_ticks;
+        if (free && (free_slot == nullptr || (free_slot->capacity < payload_size && transfer.capacity > free_slot->capacity)))
+            free_slot = &transfer;
+    }
+
+    // NOTE: fragments of a transfer whose start was lost or which was already completed don't get a slot
+    if (free_slot == nullptr || offset != 0) return nullptr;
+
+    if (free_slot->capacity < payload_size) {
+        delete[] free_slot->payload;
+        free_slot->payload = new uint8_t[payload_size];
+        free_slot->capacity = payload_size;
+    }
+
+    free_slot->used = true;
+    free_slot->from = from;
+    free_slot->to = to;
+    free_slot->id = id;
+    free_slot->payload_size = payload_size;
+    free_slot->received_size = 0;
+    free_slot->idle_ticks = 0;
+
+    return free_slot;
+}
+
+void LocalTransportRoute::clear_incoming_transfers() {
+    for (auto& transfer : m_incoming_transfers)
+        transfer.used = false;
+}
+
+void LocalTransportRoute::age_incoming_transfers() {
+    for (auto& transfer : m_incoming_transfers)
+        if (transfer.used && transfer.idle_ticks < s_max_transfer_idle_ticks) transfer.idle_ticks++;
+}
+
+bool LocalTransportRoute::write(const Connection::io_vector_t* vectors, size_t count, package_priority_t priority, bool force, bool defer) {
+    size_t total_size = 0;
+    for (size_t i = 0; i < count; i++)
+        total_size += vectors[i].size;
+
+    // NOTE: a datagram can't be sent in pieces, so there is nothing to queue
+    if (connection().datagram_oriented())
+        return connection().write_vectored(vectors, count) == total_size;
+
+    // NOTE: deferred output is handed to the connection early instead of rejecting sends
+    if (defer && m_outbound_size + total_size > m_high_watermark) defer = false;
+
+    if (!admit_write(force)) return false;
+    if (!defer && !drain_outbound_queue()) return false;
+
+    m_sent_bytes += total_size;
+
+    size_t written_size = 0;
+    if (!defer && m_outbound_size == 0)
+        written_size = connection().write_vectored(vectors, count);
+
+    if (written_size == total_size) return true;
+
+    // NOTE: the rest of a frame the connection took a part of has to be sent before any other frame
+    if (written_size > 0) {
+        m_current_priority = priority;
+        m_current_frame_left = total_size - written_size;
+    } else {
+        m_outbound_frames[(size_t)priority].push(total_size);
+    }
+
+    m_outbound_size += total_size - written_size;
+
+    // NOTE: queues whatever the connection didn't take, so no frame is ever cut short
+    auto& outbound_queue = m_outbound_queues[(size_t)priority];
+    for (size_t i = 0; i < count; i++) {
+        if (written_size >= vectors[i].size) {
+            written_size -= vectors[i].size;
+            continue;
+        }
+
+        outbound_queue.push((const uint8_t*)vectors[i].buffer + written_size, vectors[i].size - written_size);
+        written_size = 0;
+    }
+
+    return true;
+}
+
+bool LocalTransportRoute::admit_write(bool force) {
+    if (force || writable()) return true;
+
+    m_blocked = true;
+    return false;
+}
+
+bool LocalTransportRoute::drain_outbound_queue() {
+    while (m_outbound_size > 0) {
+        if (m_current_frame_left == 0) {
+            m_current_priority = next_outbound_priority();
+
+            auto& frames = m_outbound_frames[(size_t)m_current_priority];
+            m_current_frame_left = frames.front();
+            frames.pop();
+        }
+
+        auto& outbound_queue = m_outbound_queues[(size_t)m_current_priority];
+
+        size_t contiguous_size = 0;
+        const uint8_t* data = outbound_queue.front(contiguous_size);
+        contiguous_size = min_of(contiguous_size, m_current_frame_left);
+
+        size_t written_size = connection().write(data, contiguous_size);
+        outbound_queue.consume(written_size);
+        m_current_frame_left -= written_size;
+        m_outbound_size -= written_size;
+
+        if (written_size < contiguous_size) break;
+    }
+
+    return true;
+}
+
+void LocalTransportRoute::clear_outbound_queue() {
+    for (size_t i = 0; i < s_num_priorities; i++) {
+        m_outbound_queues[i].clear();
+        m_outbound_frames[i] = queue<size_t>{};
+    }
+
+    m_outbound_size = 0;
+    m_current_frame_left = 0;
+    m_interactive_frames_in_row = 0;
+    clear_batch();
+
+    while (!m_outgoing_transfers.empty()) {
+        delete[] m_outgoing_transfers.front().payload;
+        m_outgoing_transfers.pop();
+    }
+
+    while (!m_waiting_outgoing_transfers.empty()) {
+        delete[] m_waiting_outgoing_transfers.front().payload;
+        m_waiting_outgoing_transfers.pop();
+    }
+
+    m_blocked = false;
+}
+
+package_priority_t LocalTransportRoute::next_outbound_priority() {
+    if (!m_outbound_frames[(size_t)package_priority::CONTROL].empty()) return package_priority::CONTROL;
+
+    const bool interactive_queued = !m_outbound_frames[(size_t)package_priority::INTERACTIVE].empty();
+    const bool bulk_queued = !m_outbound_frames[(size_t)package_priority::BULK].empty();
+
+    // NOTE: bulk frames still get a turn while interactive ones keep coming, so they can't be starved
+    if (interactive_queued && (!bulk_queued || m_interactive_frames_in_row < s_interactive_frames_per_bulk_frame)) {
+        m_interactive_frames_in_row++;
+        return package_priority::INTERACTIVE;
+    }
+
+    m_interactive_frames_in_row = 0;
+    return package_priority::BULK;
+}
+
+bool LocalTransportRoute::take_unblocked() {
+    if (!m_blocked || m_outbound_size > m_high_watermark / 2 || !has_send_credit()) return false;
+
+    m_blocked = false;
+    return true;
+}
+
+void LocalTransportRoute::set_send_window(size_t window) {
+    m_send_credited = window > 0;
+    m_send_limit = window;
+}
+
+void LocalTransportRoute::grant_send_credit(uint32_t limit) {
+    // NOTE: compared by distance, so the limit keeps working once the counters wrapped around
+    if ((int32_t)(limit - m_send_limit) > 0) m_send_limit = limit;
+}
+
+void LocalTransportRoute::reset_flow_control() {
+    m_received_bytes = 0;
+    m_granted_limit = 0;
+    m_held_size = 0;
+    m_send_credited = false;
+    m_sent_bytes = 0;
+    m_send_limit = 0;
+}
+
 }  // namespace iac
\ No newline at end of file
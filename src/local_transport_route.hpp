@@ -5,10 +5,13 @@
 #include "forward.hpp"
 #include "logging.hpp"
 #include "network_types.hpp"
+#include "ring_buffer.hpp"
+#include "std_provider/limits.hpp"
 #include "std_provider/printf.hpp"
 #include "std_provider/queue.hpp"
 #include "std_provider/string.hpp"
 #include "std_provider/utility.hpp"
+#include "timer_wheel.hpp"
 
 namespace iac {
 
@@ -18,6 +21,7 @@ class LocalTransportRoute : public TransportRoute {
    public:
     enum class route_state {
         INITIALIZED,
+        CONNECTING,
         SEND_CONNECT,
         WAIT_CONNECT,
         SEND_ACK,
@@ -29,14 +33,88 @@ class LocalTransportRoute : public TransportRoute {
     typedef struct route_meta {
         timestamp last_package_in;
         timestamp last_package_out;
+        timestamp last_open_attempt;
+
+        // NOTE: expires no later than the next timeout or heartbeat of the route, which are only checked once it did
+        TimerWheel::Timer timer;
 
         size_t wait_for_available_size = 0;
         route_timings_t timings;
+
+        int polled_fd = -1;
+        uint32_t polled_events = 0;
+        bool poll_ready = false;
+        // NOTE: set by poll() once the other side shut the connection down, which closes the route on its next read
+        bool peer_hung_up = false;
+        // NOTE: set while the route holds output which was written without flushing the connection
+        bool flush_pending = false;
+        // NOTE: set while packages are held, because the route they are relayed over can't take them
+        bool receive_stalled = false;
+
+        // NOTE: slot handed out by the local node, the route id itself may change while connecting
+        uint8_t local_id = 0;
+
+        // NOTE: announced by the other side when connecting, 0 until then
+        size_t peer_max_frame_size = 0;
     } route_meta_t;
 
+    // a package larger than one frame, which is sent in fragments interleaved with other output
+    typedef struct outgoing_transfer {
+        ep_id_t from, to;
+        package_type_t type;
+        uint16_t id;
+
+        // NOTE: flags and header extension of the package, which every fragment carries along
+        metadata_t metadata;
+        reliable_header_t reliable;
+
+        uint8_t* payload;
+        payload_size_t payload_size;
+        payload_size_t offset;
+    } outgoing_transfer_t;
+
+    typedef struct incoming_transfer {
+        bool used = false;
+        ep_id_t from = unset_id, to = unset_id;
+        uint16_t id = 0;
+
+        uint8_t* payload = nullptr;
+        size_t capacity = 0;
+        payload_size_t payload_size = 0;
+        payload_size_t received_size = 0;
+
+        // NOTE: number of times the slots were aged since the last fragment of the transfer arrived
+        uint8_t idle_ticks = 0;
+    } incoming_transfer_t;
+
+    // COPY_PAYLOAD:  every received package owns a heap copy of its payload
+    // PAYLOAD_VIEW:  received payloads point into the receive buffer of the route and are only valid
+    //                for the duration of the handler call, use Package::retain() to keep them
+    enum class receive_mode {
+        COPY_PAYLOAD,
+        PAYLOAD_VIEW
+    };
+
     typedef route_state route_state_t;
+    typedef receive_mode receive_mode_t;
+
+    static constexpr size_t s_default_high_watermark = 1 << 16;
+    static constexpr size_t s_max_batch_size = 1 << 10;
+    static constexpr size_t s_min_frame_size = 32;
+    static constexpr size_t s_max_frame_size = numeric_limits<package_size_t>::max();
+    static constexpr size_t s_num_reassembly_slots = 4;
+    static constexpr uint8_t s_max_transfer_idle_ticks = 2;
+    static constexpr size_t s_num_priorities = 3;
+    static constexpr uint8_t s_interactive_frames_per_bulk_frame = 4;
 
     LocalTransportRoute(Connection& connection);
+    ~LocalTransportRoute() override;
+
+    // the route takes ownership of `connection` and deletes it with itself
+    static LocalTransportRoute* create_and_adopt(Connection* connection);
+
+    LocalTransportRoute(const LocalTransportRoute&) = delete;
+    LocalTransportRoute& operator=(const LocalTransportRoute&) = delete;
 
     bool reset() {
         return true;
@@ -59,10 +137,266 @@ class LocalTransportRoute : public TransportRoute {
         return *m_connection;
     };
 
+    receive_mode_t receive_mode() const {
+        return m_receive_mode;
+    };
+
+    void set_receive_mode(receive_mode_t mode) {
+        m_receive_mode = mode;
+    };
+
+    uint8_t* receive_buffer(size_t min_size);
+
+    // writes one frame behind all queued data, whatever the connection doesn't take right away is queued in the
+    // queue of `priority` and sent later
+    // returns false without writing anything while the queues are above the high watermark, unless `force` is set
+    // `defer` only appends to the queue, until it would grow past the high watermark
+    bool write(const Connection::io_vector_t* vectors, size_t count, package_priority_t priority, bool force = false, bool defer = false);
+    // false, and the route is marked as blocked, if a write would be rejected
+    bool admit_write(bool force);
+    // hands as much queued data to the connection as it takes without blocking, frame by frame in order of priority
+    // NOTE: a frame which was started is always finished first, so a control frame waits for at most one other frame
+    bool drain_outbound_queue();
+    void clear_outbound_queue();
+
+    // bytes queued in all priority classes
+    size_t outbound_size() const {
+        return m_outbound_size;
+    };
+
+    size_t outbound_size(package_priority_t priority) const {
+        return m_outbound_queues[(size_t)priority].size();
+    };
+
+    bool writable() const {
+        return m_outbound_size < m_high_watermark && has_send_credit();
+    };
+
+    size_t high_watermark() const {
+        return m_high_watermark;
+    };
+
+    void set_high_watermark(size_t high_watermark) {
+        m_high_watermark = high_watermark;
+    };
+
+    // true once after a write was rejected, as soon as the queue drained to half the high watermark
+    // and the other side granted credit again
+    bool take_unblocked();
+
+    // while enabled, small deferred packages are packed into one batch frame per flush,
+    // batch frames are always understood on the receiving side
+    bool batch_framing() const {
+        return m_batch_framing;
+    };
+
+    void set_batch_framing(bool enabled) {
+        m_batch_framing = enabled;
+    };
+
+    // room for `size` more bytes in the batch being assembled, nullptr once it would exceed `max_size`
+    // or s_max_batch_size, the batch is sent with the highest priority of its packages
+    uint8_t* reserve_batch(size_t size, size_t max_size, package_priority_t priority);
+
+    const uint8_t* batch() const {
+        return m_batch;
+    };
+
+    size_t batch_size() const {
+        return m_batch_size;
+    };
+
+    package_priority_t batch_priority() const {
+        return m_batch_priority;
+    };
+
+    void clear_batch() {
+        m_batch_size = 0;
+        m_batch_priority = package_priority::BULK;
+    };
+
+    // a received batch frame stays in the receive buffer until all of its packages were read
+    void set_received_batch(size_t begin, size_t end) {
+        m_received_batch_begin = begin;
+        m_received_batch_end = end;
+    };
+
+    size_t received_batch_left() const {
+        return m_received_batch_end - m_received_batch_begin;
+    };
+
+    // next `size` bytes of the received batch, nullptr if it is shorter
+    const uint8_t* read_received_batch(size_t size);
+
+    // largest frame this side sends and receives, pre header included, announced to the other side when connecting
+    size_t max_frame_size() const {
+        return m_max_frame_size;
+    };
+
+    void set_max_frame_size(size_t max_frame_size) {
+        m_max_frame_size = min_of(max_of(max_frame_size, s_min_frame_size), s_max_frame_size);
+    };
+
+    // frames above the smallest limit of both sides and the connection are fragmented
+    size_t frame_size_limit() {
+        size_t limit = min_of(m_max_frame_size, connection().max_frame_size());
+        return m_meta.peer_max_frame_size == 0 ? limit : min_of(limit, m_meta.peer_max_frame_size);
+    };
+
+    // bytes the other side may send ahead of what this side read, announced when connecting, 0 disables flow control
+    // NOTE: datagrams which get lost would use up credit for good, so datagram connections never announce a window
+    size_t receive_window() const {
+        return m_connection->datagram_oriented() ? 0 : m_receive_window;
+    };
+
+    void set_receive_window(size_t receive_window) {
+        m_receive_window = min_of(receive_window, (size_t)numeric_limits<int32_t>::max());
+    };
+
+    // true while either side announced a receive window
+    bool flow_controlled() const {
+        return receive_window() > 0 || m_send_credited;
+    };
+
+    // false once the bytes written reached the limit granted by the other side, writes which aren't forced are rejected until
+    // it grants more, sides which announced no window grant unlimited credit
+    bool has_send_credit() const {
+        return !m_send_credited || (int32_t)(m_send_limit - m_sent_bytes) > 0;
+    };
+
+    // called with the window the other side announced when connecting, counting starts over with the connection
+    void set_send_window(size_t window);
+    // `limit` counts all bytes written since connecting, limits which don't raise the current one are ignored
+    void grant_send_credit(uint32_t limit);
+
+    // every byte read from the connection is counted, frames read as packages as well as relayed ones
+    // NOTE: only stream connections announce a window, they lose no bytes, so both sides count the same bytes
+    //       without ever comparing their counts, which would have to happen in the order the bytes were written
+    void count_received(size_t size) {
+        m_received_bytes += size;
+    };
+
+    // packages which were read, but wait until they can be relayed, aren't counted as read until they are,
+    // so the other side gets no credit for them
+    void hold_received(size_t size) {
+        m_held_size += size;
+        m_received_bytes -= size;
+    };
+
+    void release_received(size_t size) {
+        m_held_size -= size;
+        m_received_bytes += size;
+    };
+
+    size_t held_size() const {
+        return m_held_size;
+    };
+
+    // true once the held packages take up the whole window, the connection isn't read until some of them were relayed
+    bool holding_full() const {
+        return m_held_size > 0 && m_held_size >= receive_window();
+    };
+
+    // true once half the window was read since credit was last granted to the other side
+    bool credit_update_due() const {
+        return receive_window() > 0 && (int32_t)(m_received_bytes + receive_window() - m_granted_limit) >= (int32_t)(receive_window() / 2);
+    };
+
+    // limit up to which the other side may write, remembered as granted
+    uint32_t take_credit_limit() {
+        m_granted_limit = m_received_bytes + receive_window();
+        return m_granted_limit;
+    };
+
+    // the announced window is the limit the other side starts out with
+    uint32_t announce_receive_window() {
+        m_granted_limit = receive_window();
+        return m_granted_limit;
+    };
+
+    // forgets all counted bytes and credit, once the connection is closed
+    void reset_flow_control();
+
+    // takes a copy of the payload, which is sent fragment by fragment
+    void add_outgoing_transfer(ep_id_t from, ep_id_t to, package_type_t type, metadata_t metadata, const reliable_header_t& reliable,
+                               const uint8_t* payload, payload_size_t payload_size);
+
+    bool has_outgoing_transfers() const {
+        return !m_outgoing_transfers.empty();
+    };
+
+    outgoing_transfer_t& next_outgoing_transfer() {
+        return m_outgoing_transfers.front();
+    };
+
+    // moves on to the next transfer after a fragment of the current one was written, finished transfers are dropped
+    // and make room for the next waiting one
+    void rotate_outgoing_transfers();
+
+    // reassembly slot of a transfer, its first fragment claims a free slot whose buffer is only reallocated
+    // if it is too small, nullptr if the transfer has no slot and `offset` isn't the start of a new one, or if all slots are taken
+    incoming_transfer_t* incoming_transfer(ep_id_t from, ep_id_t to, uint16_t id, payload_size_t payload_size, payload_size_t offset);
+    void clear_incoming_transfers();
+
+    // called periodically, slots of transfers which got no fragment for `s_max_transfer_idle_ticks` calls
+    // can be claimed by new transfers, since a fragment of them got lost
+    void age_incoming_transfers();
+
+    // transient routes are removed from the network once they are closed, instead of being reopened
+    bool transient() const {
+        return m_transient;
+    };
+
+    void set_transient(bool transient) {
+        m_transient = transient;
+    };
+
    private:
+    // class of the next frame to send, control frames first, interactive and bulk ones weighted
+    package_priority_t next_outbound_priority();
+
     Connection* m_connection{nullptr};
+    bool m_owns_connection{false};
+    bool m_transient{false};
     route_meta_t m_meta{};
     route_state_t m_state = route_state::INITIALIZED;
+
+    // NOTE: the sizes of the queued frames which weren't started yet are kept per class,
+    //       so the queues can be switched between frames
+    RingBuffer m_outbound_queues[s_num_priorities];
+    queue<size_t> m_outbound_frames[s_num_priorities];
+    size_t m_outbound_size{0};
+    package_priority_t m_current_priority{package_priority::CONTROL};
+    size_t m_current_frame_left{0};
+    uint8_t m_interactive_frames_in_row{0};
+
+    size_t m_high_watermark{s_default_high_watermark};
+    bool m_blocked{false};
+
+    size_t m_max_frame_size{s_max_frame_size};
+
+    size_t m_receive_window{0};
+    uint32_t m_received_bytes{0}, m_granted_limit{0};
+    size_t m_held_size{0};
+    bool m_send_credited{false};
+    uint32_t m_sent_bytes{0}, m_send_limit{0};
+
+    // NOTE: the other side reassembles as many transfers at once as it has slots, so only that many are interleaved,
+    //       the others wait until one of them finished
+    queue<outgoing_transfer_t> m_outgoing_transfers;
+    queue<outgoing_transfer_t> m_waiting_outgoing_transfers;
+    uint16_t m_next_transfer_id{0};
+    incoming_transfer_t m_incoming_transfers[s_num_reassembly_slots];
+
+    bool m_batch_framing{false};
+    uint8_t* m_batch{nullptr};
+    size_t m_batch_size{0};
+    package_priority_t m_batch_priority{package_priority::BULK};
+    size_t m_received_batch_begin{0}, m_received_batch_end{0};
+
+    receive_mode_t m_receive_mode = receive_mode::COPY_PAYLOAD;
+    uint8_t* m_receive_buffer{nullptr};
+    size_t m_receive_buffer_size{0};
 };
 
 template <typename ConnectionType>
@@ -1,5 +1,6 @@
 #pragma once
 
+#include "connection_types/shared_memory_connection.hpp"
 #include "local_node.hpp"
 #include "local_transport_route.hpp"
 
@@ -26,4 +27,36 @@ class LoopbackConnectionPackage {
     LocalTransportRoutePackage<LoopbackConnectionType> loopback_1{&loopback_queue1, &loopback_queue2};
     LocalTransportRoutePackage<LoopbackConnectionType> loopback_2{&loopback_queue2, &loopback_queue1};
 };
+
+#ifdef IAC_HAS_SHARED_MEMORY
+// NOTE: for two processes, create the package before fork() and connect one end in each process
+class SharedMemoryConnectionPackage {
+   public:
+    explicit SharedMemoryConnectionPackage(size_t ring_capacity = SharedMemoryRegion::s_default_ring_capacity)
+        : m_region(ring_capacity){};
+
+    LocalTransportRoutePackage<SharedMemoryConnection>& end1() {
+        return m_end_1;
+    };
+
+    LocalTransportRoutePackage<SharedMemoryConnection>& end2() {
+        return m_end_2;
+    };
+
+    const SharedMemoryRegion& region() const {
+        return m_region;
+    };
+
+    bool connect(LocalNode& a, LocalNode& b) {
+        return a.add_local_transport_route(end1()) && b.add_local_transport_route(end2());
+    };
+
+   private:
+    SharedMemoryRegion m_region;
+
+    LocalTransportRoutePackage<SharedMemoryConnection> m_end_1{&m_region, 0};
+    LocalTransportRoutePackage<SharedMemoryConnection> m_end_2{&m_region, 1};
+};
+#endif
+
 }  // namespace iac
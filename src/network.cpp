@@ -47,27 +47,35 @@ bool Network::remove_route(tr_id_t route_id) {
         return false;
     }
 
-    auto remove_if_not_unset = [&](tr_id_t tr_id, node_id_t node_id) {
-        if (node_id != unset_id) {
-            auto node_entry = m_node_mapping.find(node_id);
-            if (node_entry == m_node_mapping.end()) {
-                IAC_HANDLE_EXCEPTION(RemoveOfInvalidException, "linked node was non existant");
-                return false;
-            }
+    const node_id_t linked_nodes[] = {res->second->node1(), res->second->node2()};
 
-            node_entry->second->m_routes.erase(tr_id);
-            node_entry->second->m_local_routes.erase(tr_id);
+    for (auto node_id : linked_nodes) {
+        if (node_id == unset_id) continue;
 
-            if (node_entry->second->routes().empty())
-                if (!remove_node(node_id)) IAC_ASSERT_NOT_REACHED();
+        auto node_entry = m_node_mapping.find(node_id);
+        if (node_entry == m_node_mapping.end()) {
+            IAC_HANDLE_EXCEPTION(RemoveOfInvalidException, "linked node was non existant");
+            return false;
         }
-        return true;
-    };
 
-    if (!remove_if_not_unset(route_id, res->second->nodes().first)) return false;
-    if (!remove_if_not_unset(route_id, res->second->nodes().first)) return false;
+        node_entry->second->m_routes.erase(route_id);
+    }
+
+    // NOTE: no node can be reached over the route anymore
+    for (auto& node_entry : m_node_mapping)
+        node_entry.second->m_local_routes.erase(route_id);
 
     m_tr_mapping.erase(res);
+
+    // NOTE: the local node stays registered, even if it has no routes left
+    for (auto node_id : linked_nodes) {
+        if (node_id == unset_id || !node_registered(node_id)) continue;
+
+        const auto& node_entry = node(node_id);
+        if (node_entry.routes().empty() && !node_entry.local())
+            if (!remove_node(node_id)) IAC_ASSERT_NOT_REACHED();
+    }
+
     set_modified();
 
     IAC_ASSERT(validate_network());
@@ -177,8 +185,12 @@ bool Network::remove_node(node_id_t node_id) {
         if (tr_entry.node2() == node_id)
             tr_entry.set_node2(unset_id);
 
-        if (tr_entry.nodes().first == unset_id && tr_entry.nodes().second == unset_id)
-            if (!remove_route(tr_id)) IAC_ASSERT_NOT_REACHED();
+        // NOTE: the route is only linked to the node being removed, which remove_route() would see half unlinked
+        if (tr_entry.nodes().first == unset_id && tr_entry.nodes().second == unset_id) {
+            m_tr_mapping.erase(tr_id);
+            for (auto& node_entry : m_node_mapping)
+                node_entry.second->m_local_routes.erase(tr_id);
+        }
     }
 
     m_node_mapping.erase(res);
@@ -2,6 +2,7 @@
 
 #include "exceptions.hpp"
 #include "forward.hpp"
+#include "id_map.hpp"
 #include "logging.hpp"
 #include "network_types.hpp"
 #include "std_provider/limits.hpp"
@@ -16,9 +17,10 @@ class Network {
     friend LocalNode;
 
    public:
-    typedef unordered_map<ep_id_t, ManagedNetworkEntry<Endpoint>> ep_mapping_t;
-    typedef unordered_map<tr_id_t, ManagedNetworkEntry<TransportRoute>> tr_mapping_t;
-    typedef unordered_map<node_id_t, ManagedNetworkEntry<Node>> node_mapping_t;
+    // NOTE: endpoint and node ids index their slot directly, route ids are hashed
+    typedef DenseIdMap<ep_id_t, ManagedNetworkEntry<Endpoint>> ep_mapping_t;
+    typedef HashedIdMap<tr_id_t, ManagedNetworkEntry<TransportRoute>> tr_mapping_t;
+    typedef DenseIdMap<node_id_t, ManagedNetworkEntry<Node>> node_mapping_t;
 
     const auto& node_mapping() const {
         return m_node_mapping;
@@ -85,14 +87,17 @@ class Network {
     };
 
     void erase_node_managed_entry(node_id_t node_id) {
+        set_modified();
         m_node_mapping.erase(node_id);
     };
 
     void erase_endpoint_managed_entry(ep_id_t ep_id) {
+        set_modified();
         m_ep_mapping.erase(ep_id);
     };
 
     void erase_route_managed_entry(tr_id_t tr_id) {
+        set_modified();
         m_tr_mapping.erase(tr_id);
     };
 
@@ -119,15 +124,22 @@ class Network {
         m_mapping_changed = false;
     };
 
+    // counts every modification, unlike is_modified() it isn't reset once the network was sent
+    uint32_t modification_count() const {
+        return m_modification_count;
+    };
+
    private:
     void set_modified() {
         m_mapping_changed = true;
+        m_modification_count++;
     };
 
     ep_mapping_t m_ep_mapping;
     tr_mapping_t m_tr_mapping;
     node_mapping_t m_node_mapping;
     bool m_mapping_changed = false;
+    uint32_t m_modification_count = 0;
 };
 
 }  // namespace iac
\ No newline at end of file
@@ -2,6 +2,7 @@
 
 #include "exceptions.hpp"
 #include "forward.hpp"
+#include "id_map.hpp"
 #include "logging.hpp"
 #include "std_provider/limits.hpp"
 #include "std_provider/printf.hpp"
@@ -22,7 +23,20 @@ typedef uint8_t ep_id_t;
 
 typedef uint8_t package_type_t;
 typedef uint16_t package_size_t;
+typedef uint32_t payload_size_t;
 typedef uint8_t metadata_t;
+
+// header extension of reliably delivered packages and their acks
+typedef struct reliable_header {
+    // package: own sequence, ack: next sequence the receiver waits for
+    uint16_t sequence = 0;
+    // package only: oldest sequence the sender still waits for an ack of
+    uint16_t base = 0;
+    // ack only: bitmap of the sequences after `sequence` which arrived already
+    uint32_t received = 0;
+    // package: run of the sending node, ack: run of the node the acknowledged packages came from
+    uint16_t epoch = 0;
+} reliable_header_t;
 typedef uint8_t start_byte_t;
 
 enum reserved_package_types {
@@ -30,6 +44,7 @@ enum reserved_package_types {
     ACK = numeric_limits<package_type_t>::max() - 1,
     NETWORK_UPDATE = numeric_limits<package_type_t>::max() - 2,
     HEARTBEAT = numeric_limits<package_type_t>::max() - 3,
+    CREDIT = numeric_limits<package_type_t>::max() - 4,
 };
 
 enum reserved_endpoint_addresses {
@@ -38,38 +53,67 @@ enum reserved_endpoint_addresses {
 
 constexpr uint8_t unset_id = reserved_endpoint_addresses::IAC;
 
+// classes of outbound traffic, queued frames of a class go out before those of the classes after it
+// CONTROL:      packages of the nodes themselves, e.g. heartbeats, which keep the routes alive
+// INTERACTIVE:  default for packages of endpoints
+// BULK:         packages which may wait, only every few frames while interactive ones are queued
+enum class package_priority : uint8_t {
+    CONTROL,
+    INTERACTIVE,
+    BULK
+};
+
+typedef package_priority package_priority_t;
+
 typedef struct route_timings {
     uint16_t heartbeat_interval_ms = 0;
     uint16_t assume_dead_after_ms = 0;
 } route_timings_t;
 
+// point in time in microseconds, all durations passed to it are in milliseconds
 struct timestamp {
     timestamp() = default;
 
-    timestamp(size_t ts)
+    timestamp(uint64_t ts)
         : ts(ts){};
 
+    static timestamp from_ms(uint64_t ms) {
+        return ms * 1000;
+    }
+
+    // monotonic, so it is not affected by adjustments of the system time
     static timestamp now() {
 #ifdef ARDUINO
-        return millis();
+        // NOTE: micros() wraps after about 70 minutes, millis() only after 49 days
+        return from_ms(millis());
 #else
-        return std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::system_clock::now().time_since_epoch()).count();
+        return std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
 #endif
     }
 
-    bool is_more_than_n_in_past(const timestamp& now, const size_t n) {
-        return timestamp(ts + n) < now;
+    bool is_more_than_n_in_past(const timestamp& now, const size_t n) const {
+        return ts + (uint64_t)n * 1000 < now.ts;
     }
 
-    bool operator<(const timestamp& rhs) {
-        return ts < rhs.ts;
+    // first point in time at which `is_more_than_n_in_past` turns true
+    timestamp more_than_n_later(const size_t n) const {
+        return ts + (uint64_t)n * 1000 + 1;
     }
 
-    size_t operator-(const timestamp& rhs) {
-        return ts - rhs.ts;
+    // time left in milliseconds until `is_more_than_n_in_past` turns true, 0 if it already is
+    size_t until_more_than_n_in_past(const timestamp& now, const size_t n) const {
+        return is_more_than_n_in_past(now, n) ? 0 : (more_than_n_later(n).ts - now.ts + 999) / 1000;
     }
 
-    size_t ts;
+    size_t ms_since(const timestamp& earlier) const {
+        return (ts - earlier.ts) / 1000;
+    }
+
+    bool operator<(const timestamp& rhs) const {
+        return ts < rhs.ts;
+    }
+
+    uint64_t ts;
 };
 
 IAC_MAKE_EXCEPTION(EmptyNetworkEntryDereferenceException);
@@ -228,9 +272,10 @@ class Node {
    public:
     virtual ~Node() = default;
 
-    typedef unordered_set<ep_id_t> endpoint_list_t;
-    typedef unordered_set<tr_id_t> route_list_t;
-    typedef unordered_map<tr_id_t, uint8_t> local_route_list_t;
+    // NOTE: most nodes have a single endpoint and route, so routes are kept inline until there are more
+    typedef IdBitset<ep_id_t> endpoint_list_t;
+    typedef InlineIdSet<tr_id_t, 4> route_list_t;
+    typedef InlineIdMap<tr_id_t, uint8_t, 4> local_route_list_t;
 
     [[nodiscard]] node_id_t id() const {
         return m_id;
@@ -374,6 +419,8 @@ class TransportRoute {
     friend LocalNode;
 
    public:
+    virtual ~TransportRoute() = default;
+
     [[nodiscard]] const string& typestring() const {
         return m_typestring;
     };
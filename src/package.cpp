@@ -6,6 +6,18 @@ constexpr size_t Package::s_pre_header_size;
 constexpr size_t Package::s_info_header_size;
 constexpr size_t Package::s_max_payload_size;
 constexpr start_byte_t Package::s_startbyte;
+constexpr metadata_t Package::s_batch_flag;
+constexpr size_t Package::s_batch_item_header_size;
+constexpr size_t Package::s_max_batch_item_payload_size;
+constexpr metadata_t Package::s_fragment_flag;
+constexpr size_t Package::s_fragment_header_size;
+constexpr metadata_t Package::s_reliable_flag;
+constexpr metadata_t Package::s_reliable_ack_flag;
+constexpr size_t Package::s_reliable_header_size;
+constexpr size_t Package::s_reliable_ack_header_size;
+constexpr size_t Package::s_max_extension_size;
+constexpr metadata_t Package::s_control_flag;
+constexpr metadata_t Package::s_bulk_flag;
 
 Package::Package(ep_id_t from, ep_id_t to, package_type_t type, const uint8_t* buffer, size_t buffer_length, buffer_management_t buffer_type)
     : m_from(from), m_to(to), m_type(type), m_payload((uint8_t*)buffer), m_buffer_type(buffer_type) {
@@ -23,18 +35,29 @@ Package::Package(ep_id_t from, ep_id_t to, package_type_t type, const uint8_t* b
 }
 
 void Package::copy_from(const Package& other) {
+    if (m_buffer_type == buffer_management::COPY) delete[] m_payload;
+
     m_from = other.m_from;
     m_to = other.m_to;
     m_type = other.m_type;
+    m_metadata = other.m_metadata;
+    m_reliable = other.m_reliable;
+    m_over_route = other.m_over_route;
     m_payload_size = other.m_payload_size;
     m_buffer_type = buffer_management::COPY;
-    memmove(m_payload, other.m_payload, m_payload_size);
+    m_payload = new uint8_t[m_payload_size];
+    memcpy(m_payload, other.m_payload, m_payload_size);
 }
 
 void Package::move_from(Package& other) {
+    if (m_buffer_type == buffer_management::COPY) delete[] m_payload;
+
     m_from = other.m_from;
     m_to = other.m_to;
     m_type = other.m_type;
+    m_metadata = other.m_metadata;
+    m_reliable = other.m_reliable;
+    m_over_route = other.m_over_route;
     m_payload_size = other.m_payload_size;
     m_buffer_type = other.m_buffer_type;
     m_payload = other.m_payload;
@@ -50,21 +73,238 @@ Package::~Package() {
     }
 }
 
-bool Package::send_over(LocalTransportRoute* route) const {
-    package_size_t package_size = s_info_header_size + m_payload_size;
+void Package::set_priority(package_priority_t priority) {
+    m_metadata &= ~(s_control_flag | s_bulk_flag);
 
-    route->connection().write(&s_startbyte, sizeof(start_byte_t));
-    route->connection().write(&package_size, sizeof(package_size_t));
+    if (priority == package_priority::CONTROL) m_metadata |= s_control_flag;
+    if (priority == package_priority::BULK) m_metadata |= s_bulk_flag;
+}
 
-    route->connection().write(&m_metadata, sizeof(metadata_t));
-    route->connection().write(&m_to, sizeof(ep_id_t));
-    route->connection().write(&m_from, sizeof(ep_id_t));
-    route->connection().write(&m_type, sizeof(package_type_t));
+package_priority_t Package::priority_of(metadata_t metadata, ep_id_t to) {
+    if (to == reserved_endpoint_addresses::IAC || (metadata & s_control_flag)) return package_priority::CONTROL;
+    if (metadata & s_bulk_flag) return package_priority::BULK;
+    return package_priority::INTERACTIVE;
+}
 
-    if (m_payload_size > 0)
-        route->connection().write(m_payload, m_payload_size);
+bool Package::send_over(LocalTransportRoute* route, bool defer) const {
+    // NOTE: packages of the node itself keep the route alive, so they are queued even above the high watermark
+    const bool force = m_to == reserved_endpoint_addresses::IAC;
+    const package_priority_t priority = this->priority();
+
+    const size_t frame_size_limit = route->frame_size_limit();
+
+    const size_t header_size = s_info_header_size + extension_size(m_metadata);
+
+    // NOTE: fragments go out over the next updates, so packages sent afterwards can overtake them
+    if (s_pre_header_size + header_size + m_payload_size > frame_size_limit) {
+        if (!route->admit_write(force)) return false;
+
+        route->add_outgoing_transfer(m_from, m_to, m_type, m_metadata, m_reliable, m_payload, m_payload_size);
+        return true;
+    }
+
+    const size_t max_batch_size = frame_size_limit - s_pre_header_size - sizeof(metadata_t);
+    const size_t item_size = s_batch_item_header_size + m_payload_size;
+
+    if (defer && route->batch_framing() && m_metadata == 0 && m_payload_size <= s_max_batch_item_payload_size && item_size <= max_batch_size) {
+        if (!route->admit_write(force)) return false;
+
+        uint8_t* item = route->reserve_batch(item_size, max_batch_size, priority);
+        if (item == nullptr) {
+            if (!write_batch(route)) return false;
+            item = route->reserve_batch(item_size, max_batch_size, priority);
+        }
+
+        const uint8_t payload_size = m_payload_size;
+
+        memcpy(item, &m_to, sizeof(ep_id_t));
+        memcpy(item + sizeof(ep_id_t), &m_from, sizeof(ep_id_t));
+        memcpy(item + sizeof(ep_id_t) * 2, &m_type, sizeof(package_type_t));
+        memcpy(item + sizeof(ep_id_t) * 2 + sizeof(package_type_t), &payload_size, sizeof(uint8_t));
+        if (m_payload_size > 0) memcpy(item + s_batch_item_header_size, m_payload, m_payload_size);
+
+        return true;
+    }
+
+    // NOTE: batched packages were sent first
+    if (!write_batch(route)) return false;
+
+    package_size_t package_size = header_size + m_payload_size;
+
+    uint8_t header[s_pre_header_size + s_info_header_size + s_max_extension_size];
+    uint8_t* cursor = header;
+
+    auto put = [&cursor](const void* field, size_t size) {
+        memcpy(cursor, field, size);
+        cursor += size;
+    };
+
+    put(&s_startbyte, sizeof(start_byte_t));
+    put(&package_size, sizeof(package_size_t));
+
+    put(&m_metadata, sizeof(metadata_t));
+    put(&m_to, sizeof(ep_id_t));
+    put(&m_from, sizeof(ep_id_t));
+    put(&m_type, sizeof(package_type_t));
+
+    cursor = write_extension(cursor, m_metadata, m_reliable);
+
+    const Connection::io_vector_t vectors[] = {{header, (size_t)(cursor - header)}, {m_payload, m_payload_size}};
+
+    bool accepted = route->write(vectors, m_payload_size > 0 ? 2 : 1, priority, force, defer);
+
+    if (!defer) route->connection().flush();
+
+    return accepted;
+}
+
+bool Package::write_batch(LocalTransportRoute* route) {
+    if (route->batch_size() == 0) return true;
+
+    package_size_t package_size = sizeof(metadata_t) + route->batch_size();
+
+    uint8_t header[s_pre_header_size + sizeof(metadata_t)];
+    header[0] = s_startbyte;
+    memcpy(header + sizeof(start_byte_t), &package_size, sizeof(package_size_t));
+    header[s_pre_header_size] = s_batch_flag;
+
+    const Connection::io_vector_t vectors[] = {{header, sizeof(header)}, {route->batch(), route->batch_size()}};
+
+    // NOTE: every batched package was accepted already, so the frame can't be rejected anymore
+    bool written = route->write(vectors, 2, route->batch_priority(), true, true);
+    route->clear_batch();
+
+    return written;
+}
+
+bool Package::write_fragment(LocalTransportRoute* route) {
+    if (!route->admit_write(false)) return false;
+
+    auto& transfer = route->next_outgoing_transfer();
+
+    const size_t header_size = s_info_header_size + extension_size(transfer.metadata) + s_fragment_header_size;
+    const size_t max_fragment_size = route->frame_size_limit() - s_pre_header_size - header_size;
+    const payload_size_t fragment_size = min_of((size_t)(transfer.payload_size - transfer.offset), max_fragment_size);
+
+    package_size_t package_size = header_size + fragment_size;
+    metadata_t metadata = s_fragment_flag | transfer.metadata;
+
+    uint8_t header[s_pre_header_size + s_info_header_size + s_max_extension_size + s_fragment_header_size];
+    uint8_t* cursor = header;
+
+    auto put = [&cursor](const void* field, size_t size) {
+        memcpy(cursor, field, size);
+        cursor += size;
+    };
+
+    put(&s_startbyte, sizeof(start_byte_t));
+    put(&package_size, sizeof(package_size_t));
+
+    put(&metadata, sizeof(metadata_t));
+    put(&transfer.to, sizeof(ep_id_t));
+    put(&transfer.from, sizeof(ep_id_t));
+    put(&transfer.type, sizeof(package_type_t));
+
+    cursor = write_extension(cursor, transfer.metadata, transfer.reliable);
+
+    put(&transfer.id, sizeof(uint16_t));
+    put(&transfer.payload_size, sizeof(payload_size_t));
+    put(&transfer.offset, sizeof(payload_size_t));
+
+    const Connection::io_vector_t vectors[] = {{header, (size_t)(cursor - header)}, {transfer.payload + transfer.offset, fragment_size}};
+
+    // NOTE: admitted above, so a fragment is only lost if a datagram connection dropped it
+    route->write(vectors, 2, priority_of(transfer.metadata, transfer.to), true);
+
+    transfer.offset += fragment_size;
+    route->rotate_outgoing_transfers();
+
+    return true;
+}
+
+bool Package::peek_frame_header(LocalTransportRoute* route, frame_header_t& header) {
+    uint8_t headers[s_pre_header_size + s_info_header_size];
+
+    if (route->connection().available() < sizeof(headers) || route->connection().peek(headers, sizeof(headers)) != sizeof(headers))
+        return false;
+
+    if (headers[0] != s_startbyte) return false;
+
+    package_size_t package_size = 0;
+    memcpy(&package_size, headers + sizeof(start_byte_t), sizeof(package_size_t));
+
+    if (package_size < s_info_header_size || route->connection().available() < s_pre_header_size + package_size)
+        return false;
+
+    const uint8_t* cursor = headers + s_pre_header_size;
+
+    auto get = [&cursor](void* field, size_t size) {
+        memcpy(field, cursor, size);
+        cursor += size;
+    };
+
+    header.frame_size = s_pre_header_size + package_size;
+    get(&header.metadata, sizeof(metadata_t));
+    get(&header.to, sizeof(ep_id_t));
+    get(&header.from, sizeof(ep_id_t));
+    get(&header.type, sizeof(package_type_t));
+
+    return true;
+}
+
+bool Package::forward_frame(LocalTransportRoute* from_route, LocalTransportRoute* to_route, size_t frame_size, package_priority_t priority, bool defer) {
+    // NOTE: the frame passes through the receive buffer of the route it arrived on, nothing is decoded
+    uint8_t* frame = from_route->receive_buffer(frame_size);
+
+    if (from_route->connection().read(frame, frame_size) != frame_size) {
+        IAC_HANDLE_FATAL_EXCEPTION(InvalidPackageException, "reading forwarded frame returned less bytes than 'available'");
+        return false;
+    }
+
+    from_route->count_received(frame_size);
+
+    if (!write_batch(to_route)) return false;
+
+    const Connection::io_vector_t vector{frame, frame_size};
+    bool accepted = to_route->write(&vector, 1, priority, false, defer);
+
+    if (!defer) to_route->connection().flush();
+
+    return accepted;
+}
+
+bool Package::read_batch_item(LocalTransportRoute* route) {
+    m_over_route = route;
+
+    const uint8_t* item = route->read_received_batch(s_batch_item_header_size);
+
+    uint8_t payload_size = 0;
+    if (item != nullptr) {
+        memcpy(&m_to, item, sizeof(ep_id_t));
+        memcpy(&m_from, item + sizeof(ep_id_t), sizeof(ep_id_t));
+        memcpy(&m_type, item + sizeof(ep_id_t) * 2, sizeof(package_type_t));
+        memcpy(&payload_size, item + sizeof(ep_id_t) * 2 + sizeof(package_type_t), sizeof(uint8_t));
+    }
+
+    const uint8_t* payload = item == nullptr ? nullptr : route->read_received_batch(payload_size);
+
+    if (payload == nullptr) {
+        iac_log(Logging::loglevels::warning, "corrupt batch frame\n");
+        route->set_received_batch(0, 0);
+        return false;
+    }
+
+    m_metadata = 0;
+    m_payload_size = payload_size;
 
-    route->connection().flush();
+    if (route->receive_mode() == LocalTransportRoute::receive_mode::PAYLOAD_VIEW) {
+        m_payload = (uint8_t*)payload;
+        m_buffer_type = buffer_management::IN_PLACE;
+    } else {
+        m_payload = new uint8_t[m_payload_size];
+        m_buffer_type = buffer_management::COPY;
+        memcpy(m_payload, payload, m_payload_size);
+    }
 
     return true;
 }
@@ -72,79 +312,163 @@ bool Package::send_over(LocalTransportRoute* route) const {
 bool Package::read_from(LocalTransportRoute* route) {
     m_over_route = route;
 
+    if (route->received_batch_left() > 0)
+        return read_batch_item(route);
+
 #ifdef ARDUINO
     uint8_t dummy = 0;
     route->connection().write(&dummy, 1);
 #endif
 
+    // NOTE: fragments are collected until one completes its package or no whole frame is left
+    bool fragment_consumed = false;
+
+    do {
+        fragment_consumed = false;
+        if (read_frame(route, fragment_consumed)) return true;
+    } while (fragment_consumed);
+
+    return false;
+}
+
+bool Package::read_frame(LocalTransportRoute* route, bool& fragment_consumed) {
     if (route->meta().wait_for_available_size > 0 && route->connection().available() < route->meta().wait_for_available_size)
         return false;
 
-    if (route->connection().available() < s_pre_header_size)
+    // NOTE: a datagram holds exactly one frame, so a datagram which turns out to be corrupt is dropped whole
+    //       instead of searching it for the next start byte, or waiting for the rest of the frame
+    const bool datagram_oriented = route->connection().datagram_oriented();
+
+    if (route->connection().available() < s_pre_header_size) {
+        if (datagram_oriented) drop_datagram(route);
         return false;
+    }
 
     route->meta().wait_for_available_size = 0;
 
-    start_byte_t start_byte = 0;
+    uint8_t pre_header[s_pre_header_size]{0};
 
     while (route->connection().available() >= s_pre_header_size) {
-        if (route->connection().read(&start_byte, sizeof(start_byte_t)) != sizeof(start_byte_t)) {
-            IAC_HANDLE_FATAL_EXCEPTION(InvalidPackageException, "reading start_byte returned less bytes than 'available'");
+        if (route->connection().peek(pre_header, s_pre_header_size) != s_pre_header_size) {
+            IAC_HANDLE_FATAL_EXCEPTION(InvalidPackageException, "peeking pre header returned less bytes than 'available'");
 
             return false;
         }
 
-        if (start_byte == s_startbyte)
+        if (pre_header[0] == s_startbyte)
             break;
 
+        if (datagram_oriented) {
+            drop_datagram(route);
+            return false;
+        }
+
         // NOTE: zero-bytes can be used as dummy writes by transport routes, so no warning to avoid spamming
-        if (start_byte != 0)
+        if (pre_header[0] != 0) {
             iac_log(Logging::loglevels::warning, "corrupt message start\n");
+            route->count_received(sizeof(start_byte_t));
+        }
+
+        route->connection().consume(sizeof(start_byte_t));
     }
 
-    if (start_byte != s_startbyte) return false;
+    if (pre_header[0] != s_startbyte) return false;
 
     package_size_t package_size = 0;
-    if (route->connection().read(&package_size, sizeof(package_size_t)) != sizeof(package_size_t)) {
-        IAC_HANDLE_FATAL_EXCEPTION(InvalidPackageException, "reading package_len returned less bytes than 'available'");
+    memcpy(&package_size, pre_header + sizeof(start_byte_t), sizeof(package_size_t));
 
+    if (package_size < s_info_header_size) {
+        if (datagram_oriented) {
+            drop_datagram(route);
+            return false;
+        }
+
+        iac_log(Logging::loglevels::warning, "corrupt message size\n");
+        route->connection().consume(sizeof(start_byte_t));
+        route->count_received(sizeof(start_byte_t));
         return false;
     }
 
-    if (route->connection().available() < package_size) {
-        route->connection().put_back(&start_byte, sizeof(start_byte_t));
-        route->connection().put_back(&package_size, sizeof(package_size_t));
-        route->meta().wait_for_available_size = package_size + s_pre_header_size;
+    // NOTE: the pre header stays in the connection until the whole package is available
+    if (route->connection().available() < s_pre_header_size + package_size) {
+        if (datagram_oriented) {
+            drop_datagram(route);
+            return false;
+        }
+
+        route->meta().wait_for_available_size = s_pre_header_size + package_size;
         return false;
     }
 
-    if (route->connection().read(&m_metadata, sizeof(metadata_t)) != sizeof(metadata_t)) {
-        IAC_HANDLE_FATAL_EXCEPTION(InvalidPackageException, "reading meta returned less bytes than 'available'");
+    route->connection().consume(s_pre_header_size);
+
+    // NOTE: every path from here on consumes the whole frame
+    route->count_received(s_pre_header_size + package_size);
 
+    metadata_t metadata = 0;
+    if (route->connection().peek(&metadata, sizeof(metadata_t)) != sizeof(metadata_t)) {
+        IAC_HANDLE_FATAL_EXCEPTION(InvalidPackageException, "peeking metadata returned less bytes than 'available'");
         return false;
     }
 
-    if (route->connection().read(&m_to, sizeof(ep_id_t)) != sizeof(ep_id_t)) {
-        IAC_HANDLE_FATAL_EXCEPTION(InvalidPackageException, "reading to_addr returned less bytes than 'available'");
+    // NOTE: the packages of a batch frame are read from the receive buffer one after another
+    if (metadata & s_batch_flag) {
+        uint8_t* batch = route->receive_buffer(package_size);
 
-        return false;
+        if (route->connection().read(batch, package_size) != package_size) {
+            IAC_HANDLE_FATAL_EXCEPTION(InvalidPackageException, "reading batch frame returned less bytes than 'available'");
+            return false;
+        }
+
+        route->set_received_batch(sizeof(metadata_t), package_size);
+        return read_batch_item(route);
     }
 
-    if (route->connection().read(&m_from, sizeof(ep_id_t)) != sizeof(ep_id_t)) {
-        IAC_HANDLE_FATAL_EXCEPTION(InvalidPackageException, "reading from_addr returned less bytes than 'available'");
+    const size_t header_size = s_info_header_size + extension_size(metadata);
 
+    if (package_size < header_size) {
+        iac_log(Logging::loglevels::warning, "corrupt message size\n");
+        route->connection().consume(package_size);
         return false;
     }
 
-    if (route->connection().read(&m_type, sizeof(package_type_t)) != sizeof(package_type_t)) {
-        IAC_HANDLE_FATAL_EXCEPTION(InvalidPackageException, "reading type returned less bytes than 'available'");
+    const bool payload_view = route->receive_mode() == LocalTransportRoute::receive_mode::PAYLOAD_VIEW;
+
+    // NOTE: in PAYLOAD_VIEW mode the whole frame is kept contiguous in the receive buffer of the route
+    uint8_t* frame = route->receive_buffer(payload_view ? package_size : header_size);
+
+    if (route->connection().read(frame, header_size) != header_size) {
+        IAC_HANDLE_FATAL_EXCEPTION(InvalidPackageException, "reading info header returned less bytes than 'available'");
 
         return false;
     }
 
-    m_payload_size = package_size - s_info_header_size;
-    m_payload = new uint8_t[m_payload_size];
-    m_buffer_type = buffer_management::COPY;  // we need to delete this on deconstruction
+    const uint8_t* cursor = frame;
+
+    auto get = [&cursor](void* field, size_t size) {
+        memcpy(field, cursor, size);
+        cursor += size;
+    };
+
+    get(&m_metadata, sizeof(metadata_t));
+    get(&m_to, sizeof(ep_id_t));
+    get(&m_from, sizeof(ep_id_t));
+    get(&m_type, sizeof(package_type_t));
+
+    read_extension(cursor, m_metadata, m_reliable);
+
+    if (m_metadata & s_fragment_flag)
+        return read_fragment(route, package_size - header_size, fragment_consumed);
+
+    m_payload_size = package_size - header_size;
+
+    if (payload_view) {
+        m_payload = frame + header_size;
+        m_buffer_type = buffer_management::IN_PLACE;
+    } else {
+        m_payload = new uint8_t[m_payload_size];
+        m_buffer_type = buffer_management::COPY;  // we need to delete this on deconstruction
+    }
 
     if (m_payload_size > 0)
         if (route->connection().read(m_payload, m_payload_size) != m_payload_size) {
@@ -160,6 +484,134 @@ bool Package::read_from(LocalTransportRoute* route) {
     return true;
 }
 
+void Package::drop_datagram(LocalTransportRoute* route) {
+    const size_t size = route->connection().available();
+    if (size == 0) return;
+
+    iac_log(Logging::loglevels::warning, "corrupt datagram, dropping %lu bytes\n", (unsigned long)size);
+    route->connection().consume(size);
+    route->count_received(size);
+}
+
+bool Package::read_fragment(LocalTransportRoute* route, size_t size, bool& fragment_consumed) {
+    fragment_consumed = true;
+
+    if (size < s_fragment_header_size) {
+        iac_log(Logging::loglevels::warning, "corrupt fragment size\n");
+        route->connection().consume(size);
+        return false;
+    }
+
+    uint8_t fragment_header[s_fragment_header_size];
+
+    if (route->connection().read(fragment_header, s_fragment_header_size) != s_fragment_header_size) {
+        IAC_HANDLE_FATAL_EXCEPTION(InvalidPackageException, "reading fragment header returned less bytes than 'available'");
+        return false;
+    }
+
+    uint16_t id = 0;
+    payload_size_t payload_size = 0, offset = 0;
+
+    memcpy(&id, fragment_header, sizeof(uint16_t));
+    memcpy(&payload_size, fragment_header + sizeof(uint16_t), sizeof(payload_size_t));
+    memcpy(&offset, fragment_header + sizeof(uint16_t) + sizeof(payload_size_t), sizeof(payload_size_t));
+
+    const size_t fragment_size = size - s_fragment_header_size;
+
+    LocalTransportRoute::incoming_transfer_t* transfer = nullptr;
+    if (payload_size <= s_max_payload_size && (size_t)offset + fragment_size <= payload_size)
+        transfer = route->incoming_transfer(m_from, m_to, id, payload_size, offset);
+
+    if (transfer == nullptr) {
+        iac_log(Logging::loglevels::warning, "dropping fragment of transfer %u from %d\n", id, m_from);
+        route->connection().consume(fragment_size);
+        return false;
+    }
+
+    // NOTE: fragments are written in order, so earlier offsets are duplicates and later ones mean a fragment got lost,
+    //       the transfer could never complete without holes then
+    if (offset != transfer->received_size) {
+        if (offset > transfer->received_size) {
+            iac_log(Logging::loglevels::warning, "fragment of transfer %u from %d got lost, dropping transfer\n", id, m_from);
+            transfer->used = false;
+        }
+
+        route->connection().consume(fragment_size);
+        return false;
+    }
+
+    // NOTE: fragments are read straight into the reassembly buffer of the route
+    if (route->connection().read(transfer->payload + offset, fragment_size) != fragment_size) {
+        IAC_HANDLE_FATAL_EXCEPTION(InvalidPackageException, "reading fragment returned less bytes than 'available'");
+        return false;
+    }
+
+    transfer->received_size += fragment_size;
+    transfer->idle_ticks = 0;
+    if (transfer->received_size < transfer->payload_size) return false;
+
+    // NOTE: the slot can be claimed again, but its buffer is only overwritten once this package was handled
+    transfer->used = false;
+    fragment_consumed = false;
+
+    m_metadata &= ~s_fragment_flag;
+    m_payload = transfer->payload;
+    m_payload_size = transfer->payload_size;
+    m_buffer_type = buffer_management::IN_PLACE;
+
+    return true;
+}
+
+size_t Package::extension_size(metadata_t metadata) {
+    if (metadata & s_reliable_flag) return s_reliable_header_size;
+    if (metadata & s_reliable_ack_flag) return s_reliable_ack_header_size;
+    return 0;
+}
+
+uint8_t* Package::write_extension(uint8_t* buffer, metadata_t metadata, const reliable_header_t& reliable) {
+    if (metadata & (s_reliable_flag | s_reliable_ack_flag)) {
+        memcpy(buffer, &reliable.sequence, sizeof(uint16_t));
+        buffer += sizeof(uint16_t);
+    }
+
+    if (metadata & s_reliable_flag) {
+        memcpy(buffer, &reliable.base, sizeof(uint16_t));
+        buffer += sizeof(uint16_t);
+    } else if (metadata & s_reliable_ack_flag) {
+        memcpy(buffer, &reliable.received, sizeof(uint32_t));
+        buffer += sizeof(uint32_t);
+    }
+
+    if (metadata & (s_reliable_flag | s_reliable_ack_flag)) {
+        memcpy(buffer, &reliable.epoch, sizeof(uint16_t));
+        buffer += sizeof(uint16_t);
+    }
+
+    return buffer;
+}
+
+const uint8_t* Package::read_extension(const uint8_t* buffer, metadata_t metadata, reliable_header_t& reliable) {
+    if (metadata & (s_reliable_flag | s_reliable_ack_flag)) {
+        memcpy(&reliable.sequence, buffer, sizeof(uint16_t));
+        buffer += sizeof(uint16_t);
+    }
+
+    if (metadata & s_reliable_flag) {
+        memcpy(&reliable.base, buffer, sizeof(uint16_t));
+        buffer += sizeof(uint16_t);
+    } else if (metadata & s_reliable_ack_flag) {
+        memcpy(&reliable.received, buffer, sizeof(uint32_t));
+        buffer += sizeof(uint32_t);
+    }
+
+    if (metadata & (s_reliable_flag | s_reliable_ack_flag)) {
+        memcpy(&reliable.epoch, buffer, sizeof(uint16_t));
+        buffer += sizeof(uint16_t);
+    }
+
+    return buffer;
+}
+
 void Package::print() const {
     iac_printf("package @%p:\n", this);
     iac_printf("\tmeta: 0x%02x\n", m_metadata);
@@ -174,7 +626,7 @@ void Package::print() const {
     for (unsigned i = 0; i < m_payload_size && i < bytes_per_line * max_lines; i++)
         iac_printf((i % bytes_per_line == bytes_per_line - 1 && i + 1 < m_payload_size) ? " @0x%02x:0x%02x[%c]\n\t        " : " @0x%02x:0x%02x[%c]", i, m_payload[i], (m_payload[i] >= ' ' && m_payload[i] <= '\x7f') ? m_payload[i] : '.');
 
-    iac_printf("\n\tpayload_size: %d\n\n", m_payload_size);
+    iac_printf("\n\tpayload_size: %lu\n\n", (unsigned long)m_payload_size);
 }
 
 }  // namespace iac
\ No newline at end of file
@@ -61,7 +61,7 @@ class Package {
         return m_payload;
     };
 
-    package_size_t payload_size() const {
+    payload_size_t payload_size() const {
         return m_payload_size;
     };
 
@@ -81,7 +81,7 @@ class Package {
         return m_payload;
     };
 
-    package_size_t& payload_size() {
+    payload_size_t& payload_size() {
         return m_payload_size;
     };
 
@@ -89,11 +89,55 @@ class Package {
         return m_over_route;
     };
 
+    // packages for the node itself are always sent as control packages
+    package_priority_t priority() const {
+        return priority_of(m_metadata, m_to);
+    };
+
+    void set_priority(package_priority_t priority);
+
+    // returns a package owning a copy of the payload, which stays valid after the handler returned
+    Package retain() const {
+        return Package{*this};
+    };
+
     void print() const;
 
    protected:
-    bool send_over(LocalTransportRoute* route) const;
+    typedef struct frame_header {
+        size_t frame_size;
+        metadata_t metadata;
+        ep_id_t to, from;
+        package_type_t type;
+    } frame_header_t;
+
+    bool send_over(LocalTransportRoute* route, bool defer = false) const;
     bool read_from(LocalTransportRoute* route);
+    // drops the rest of the current datagram of a datagram oriented `route`, which holds no complete frame
+    static void drop_datagram(LocalTransportRoute* route);
+
+    // writes the packages batched on `route` as one frame
+    static bool write_batch(LocalTransportRoute* route);
+    bool read_batch_item(LocalTransportRoute* route);
+
+    // writes the next fragment of the transfers on `route`, false if the route can't take more output
+    static bool write_fragment(LocalTransportRoute* route);
+
+    static package_priority_t priority_of(metadata_t metadata, ep_id_t to);
+
+    // decodes the headers of the next frame without consuming it, false unless the whole frame is available
+    static bool peek_frame_header(LocalTransportRoute* route, frame_header_t& header);
+    // copies the next frame as it is from `from_route` to `to_route`, it is consumed even if `to_route` rejects it
+    static bool forward_frame(LocalTransportRoute* from_route, LocalTransportRoute* to_route, size_t frame_size, package_priority_t priority, bool defer);
+
+    // `fragment_consumed` is set if a fragment was read which did not complete its package yet
+    bool read_frame(LocalTransportRoute* route, bool& fragment_consumed);
+    bool read_fragment(LocalTransportRoute* route, size_t size, bool& fragment_consumed);
+
+    // size of the header extension which follows the info header of frames with `metadata`
+    static size_t extension_size(metadata_t metadata);
+    static uint8_t* write_extension(uint8_t* buffer, metadata_t metadata, const reliable_header_t& reliable);
+    static const uint8_t* read_extension(const uint8_t* buffer, metadata_t metadata, reliable_header_t& reliable);
 
     void copy_from(const Package& other);
     void move_from(Package& other);
@@ -101,17 +145,45 @@ class Package {
    private:
     static constexpr size_t s_pre_header_size = sizeof(start_byte_t) + sizeof(package_size_t);
     static constexpr size_t s_info_header_size = sizeof(ep_id_t) * 2 + sizeof(metadata_t) + sizeof(package_type_t);
-    static constexpr size_t s_max_payload_size = numeric_limits<package_size_t>::max() - s_info_header_size;
+    // NOTE: packages which don't fit into one frame are fragmented, the limit bounds the reassembly buffers
+    static constexpr size_t s_max_payload_size = 1 << 24;
     static constexpr start_byte_t s_startbyte = 0b10101010;
 
+    // NOTE: a batch frame carries its metadata byte followed by packages with a compact item header each,
+    //       only packages with a payload fitting into the one byte size field are batched
+    static constexpr metadata_t s_batch_flag = 1 << 0;
+    static constexpr size_t s_batch_item_header_size = sizeof(ep_id_t) * 2 + sizeof(package_type_t) + sizeof(uint8_t);
+    static constexpr size_t s_max_batch_item_payload_size = numeric_limits<uint8_t>::max();
+
+    // NOTE: every fragment carries the info header of its package, followed by the transfer id,
+    //       the size of the whole payload and the offset of the fragment
+    static constexpr metadata_t s_fragment_flag = 1 << 1;
+    static constexpr size_t s_fragment_header_size = sizeof(uint16_t) + sizeof(payload_size_t) * 2;
+
+    // NOTE: reliably delivered packages and their acks carry a header extension behind the info header,
+    //       packages their sequence and the oldest unacknowledged sequence of the sender,
+    //       acks the next sequence the receiver waits for and a bitmap of the sequences after it,
+    //       both end with the epoch of the node which sent the packages
+    static constexpr metadata_t s_reliable_flag = 1 << 2;
+    static constexpr metadata_t s_reliable_ack_flag = 1 << 3;
+    static constexpr size_t s_reliable_header_size = sizeof(uint16_t) * 3;
+    static constexpr size_t s_reliable_ack_header_size = sizeof(uint16_t) * 2 + sizeof(uint32_t);
+    static constexpr size_t s_max_extension_size = s_reliable_ack_header_size;
+
+    // NOTE: the priority travels along with the package, so relays queue it in the same class,
+    //       interactive packages carry neither flag
+    static constexpr metadata_t s_control_flag = 1 << 4;
+    static constexpr metadata_t s_bulk_flag = 1 << 5;
+
     ep_id_t m_from{unset_id}, m_to{unset_id};
 
     package_type_t m_type{0};
 
     metadata_t m_metadata = {0};
+    reliable_header_t m_reliable{};
 
     uint8_t* m_payload{nullptr};
-    package_size_t m_payload_size{0};
+    payload_size_t m_payload_size{0};
 
     buffer_management_t m_buffer_type{buffer_management::EMPTY};
 
@@ -0,0 +1,92 @@
+#include "reliable_stream.hpp"
+
+namespace iac {
+
+constexpr uint16_t ReliableSender::s_window_size;
+
+ReliableSender::entry_t& ReliableSender::push(const Package& package) {
+    auto& new_entry = entry(m_next_sequence++);
+
+    new_entry.used = true;
+    new_entry.num_transmissions = 0;
+    new_entry.last_transmission = 0;
+    new_entry.package = package;
+
+    return new_entry;
+}
+
+void ReliableSender::acknowledge(uint16_t next_expected, uint32_t received) {
+    for (uint16_t sequence = m_base; sequence != m_next_sequence; sequence++) {
+        const auto distance = (int16_t)(sequence - next_expected);
+
+        if (distance < 0 || (distance > 0 && distance <= 32 && (received >> (distance - 1)) & 1u))
+            drop(sequence);
+    }
+}
+
+void ReliableSender::drop(uint16_t sequence) {
+    auto& dropped = entry(sequence);
+    if (!dropped.used) return;
+
+    dropped.used = false;
+    dropped.package = Package{};
+
+    advance_base();
+}
+
+void ReliableSender::advance_base() {
+    while (m_base != m_next_sequence && !entry(m_base).used)
+        m_base++;
+}
+
+bool ReliableReceiver::accept(uint16_t sequence, uint16_t base, uint16_t epoch) {
+    m_ack_pending = true;
+
+    const auto lag = (int16_t)(m_next_expected - base);
+
+    // NOTE: a restarted sender starts over with a new epoch, while its sequences may still look like duplicates.
+    //       A sender never lags more than its window behind either, so the stream is out of sync if it does
+    if (!m_synchronized || epoch != m_epoch || lag > (int16_t)ReliableSender::s_window_size || lag < -(int16_t)ReliableSender::s_window_size) {
+        m_synchronized = true;
+        m_epoch = epoch;
+        m_next_expected = base;
+        m_received = 0;
+    }
+
+    // NOTE: the sender gave up on the packages before its base
+    skip_to(base);
+
+    const auto distance = (int16_t)(sequence - m_next_expected);
+
+    if (distance < 0 || distance > 32) return false;
+
+    if (distance == 0) {
+        skip_to(m_next_expected + 1);
+        return true;
+    }
+
+    const uint32_t bit = 1u << (distance - 1);
+    if (m_received & bit) return false;
+
+    m_received |= bit;
+    return true;
+}
+
+void ReliableReceiver::skip_to(uint16_t sequence) {
+    bool next_arrived = false;
+
+    while ((int16_t)(sequence - m_next_expected) > 0) {
+        next_arrived = m_received & 1u;
+        m_received >>= 1;
+        m_next_expected++;
+    }
+
+    // NOTE: packages which arrived early were delivered already
+    while (next_arrived) {
+        next_arrived = m_received & 1u;
+        m_received >>= 1;
+        m_next_expected++;
+    }
+}
+
+}  // namespace iac
\ No newline at end of file
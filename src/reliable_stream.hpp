@@ -0,0 +1,113 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+#include "network_types.hpp"
+#include "package.hpp"
+#include "timer_wheel.hpp"
+
+namespace iac {
+
+// sending side of the reliable packages from a local to a remote endpoint,
+// every package is kept until the receiving node acknowledged it
+class ReliableSender {
+   public:
+    // NOTE: bounded by the bitmap of the acks
+    static constexpr uint16_t s_window_size = 32;
+
+    typedef struct entry {
+        bool used = false;
+        uint8_t num_transmissions = 0;
+        timestamp last_transmission{0};
+        Package package;
+    } entry_t;
+
+    bool full() const {
+        return (uint16_t)(m_next_sequence - m_base) >= s_window_size;
+    };
+
+    bool empty() const {
+        return m_next_sequence == m_base;
+    };
+
+    // oldest sequence which was not acknowledged yet
+    uint16_t base() const {
+        return m_base;
+    };
+
+    uint16_t next_sequence() const {
+        return m_next_sequence;
+    };
+
+    entry_t& entry(uint16_t sequence) {
+        return m_window[sequence % s_window_size];
+    };
+
+    // takes a copy of `package` under the next sequence, the window must not be full
+    entry_t& push(const Package& package);
+
+    // drops the packages an ack covers, `next_expected` and `received` as in reliable_header_t
+    void acknowledge(uint16_t next_expected, uint32_t received);
+    void drop(uint16_t sequence);
+
+    TimerWheel::Timer& timer() {
+        return m_timer;
+    };
+
+    const TimerWheel::Timer& timer() const {
+        return m_timer;
+    };
+
+   private:
+    void advance_base();
+
+    entry_t m_window[s_window_size];
+    uint16_t m_base{0};
+    uint16_t m_next_sequence{0};
+
+    // NOTE: expires no later than the next retransmission of the window
+    TimerWheel::Timer m_timer;
+};
+
+// receiving side of the reliable packages from a remote to a local endpoint
+class ReliableReceiver {
+   public:
+    // false if the package with `sequence` was accepted already, `base` is the oldest sequence the sender waits for
+    // and `epoch` the run of the sending node
+    bool accept(uint16_t sequence, uint16_t base, uint16_t epoch);
+
+    // run of the sending node the packages accepted last came from
+    uint16_t epoch() const {
+        return m_epoch;
+    };
+
+    uint16_t next_expected() const {
+        return m_next_expected;
+    };
+
+    uint32_t received() const {
+        return m_received;
+    };
+
+    // NOTE: set for every received package, so lost acks are answered by retransmissions
+    bool ack_pending() const {
+        return m_ack_pending;
+    };
+
+    void set_ack_pending(bool pending) {
+        m_ack_pending = pending;
+    };
+
+   private:
+    void skip_to(uint16_t sequence);
+
+    bool m_synchronized{false};
+    bool m_ack_pending{false};
+    uint16_t m_epoch{0};
+    uint16_t m_next_expected{0};
+    // NOTE: bit n is set if the package with sequence `m_next_expected + 1 + n` arrived
+    uint32_t m_received{0};
+};
+
+}  // namespace iac
@@ -0,0 +1,87 @@
+#include "ring_buffer.hpp"
+
+namespace iac {
+
+constexpr size_t RingBuffer::s_min_capacity;
+
+RingBuffer::~RingBuffer() {
+    delete[] m_buffer;
+}
+
+void RingBuffer::reserve(size_t min_capacity) {
+    if (m_capacity >= min_capacity) return;
+
+    size_t new_capacity = m_capacity > 0 ? m_capacity : s_min_capacity;
+    while (new_capacity < min_capacity)
+        new_capacity *= 2;
+
+    auto* new_buffer = new uint8_t[new_capacity];
+    peek(new_buffer, m_size);
+
+    delete[] m_buffer;
+
+    m_buffer = new_buffer;
+    m_capacity = new_capacity;
+    m_head = 0;
+}
+
+void RingBuffer::push(const void* buffer, size_t size) {
+    if (size == 0) return;
+
+    reserve(m_size + size);
+
+    auto* cursor = (const uint8_t*)buffer;
+    size_t tail = wrap(m_head + m_size);
+    size_t first_block_size = min_of(size, m_capacity - tail);
+
+    memcpy(m_buffer + tail, cursor, first_block_size);
+    memcpy(m_buffer, cursor + first_block_size, size - first_block_size);
+
+    m_size += size;
+}
+
+size_t RingBuffer::peek(void* buffer, size_t size) const {
+    size = min_of(size, m_size);
+    if (size == 0) return 0;
+
+    auto* cursor = (uint8_t*)buffer;
+    size_t first_block_size = min_of(size, m_capacity - m_head);
+
+    memcpy(cursor, m_buffer + m_head, first_block_size);
+    memcpy(cursor + first_block_size, m_buffer, size - first_block_size);
+
+    return size;
+}
+
+size_t RingBuffer::pop(void* buffer, size_t size) {
+    return consume(peek(buffer, size));
+}
+
+size_t RingBuffer::consume(size_t size) {
+    size = min_of(size, m_size);
+
+    m_size -= size;
+    m_head = m_size == 0 ? 0 : wrap(m_head + size);
+
+    return size;
+}
+
+const uint8_t* RingBuffer::front(size_t& contiguous_size) const {
+    contiguous_size = min_of(m_size, m_capacity - m_head);
+    return m_buffer + m_head;
+}
+
+uint8_t* RingBuffer::back(size_t min_size, size_t& contiguous_size) {
+    reserve(m_size + min_size);
+
+    size_t tail = wrap(m_head + m_size);
+    contiguous_size = min_of(m_capacity - m_size, m_capacity - tail);
+
+    return m_buffer + tail;
+}
+
+void RingBuffer::commit(size_t size) {
+    m_size += min_of(size, m_capacity - m_size);
+}
+
+}  // namespace iac
@@ -0,0 +1,68 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+#include "std_provider/string.hpp"
+#include "std_provider/utility.hpp"
+
+namespace iac {
+
+// contiguous, growable byte fifo
+// capacity is always a power of two, so wrapping the indices is a simple mask
+class RingBuffer {
+   public:
+    RingBuffer() = default;
+    ~RingBuffer();
+
+    RingBuffer(const RingBuffer&) = delete;
+    RingBuffer& operator=(const RingBuffer&) = delete;
+
+    size_t size() const {
+        return m_size;
+    };
+
+    size_t capacity() const {
+        return m_capacity;
+    };
+
+    bool empty() const {
+        return m_size == 0;
+    };
+
+    void push(const void* buffer, size_t size);
+
+    size_t peek(void* buffer, size_t size) const;
+    size_t pop(void* buffer, size_t size);
+    size_t consume(size_t size);
+
+    void clear() {
+        m_head = 0;
+        m_size = 0;
+    };
+
+    // direct access to the first contiguous block of stored bytes, release it with consume()
+    const uint8_t* front(size_t& contiguous_size) const;
+
+    // direct access to free space with at least `min_size` bytes (not necessarily contiguous),
+    // `contiguous_size` returns the size of the writable block, publish written bytes with commit()
+    uint8_t* back(size_t min_size, size_t& contiguous_size);
+    void commit(size_t size);
+
+   private:
+    static constexpr size_t s_min_capacity = 64;
+
+    void reserve(size_t min_capacity);
+
+    size_t wrap(size_t index) const {
+        return index & (m_capacity - 1);
+    };
+
+    uint8_t* m_buffer{nullptr};
+    size_t m_capacity{0};
+
+    size_t m_head{0};
+    size_t m_size{0};
+};
+
+}  // namespace iac
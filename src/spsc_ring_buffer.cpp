@@ -0,0 +1,86 @@
+#ifndef ARDUINO
+
+#    include "spsc_ring_buffer.hpp"
+
+namespace iac {
+
+constexpr size_t SpscRingBuffer::s_cache_line_size;
+
+SpscRingBuffer::SpscRingBuffer(control_t* control, uint8_t* buffer, size_t capacity)
+    : m_control(control), m_buffer(buffer), m_capacity(capacity) {}
+
+size_t SpscRingBuffer::free_space() const {
+    if (m_control == nullptr) return 0;
+
+    return m_capacity - (m_control->head.load(std::memory_order_relaxed) - m_control->tail.load(std::memory_order_acquire));
+}
+
+bool SpscRingBuffer::push(const void* buffer, size_t size) {
+    if (size > free_space()) return false;
+    if (size == 0) return true;
+
+    const size_t head = m_control->head.load(std::memory_order_relaxed);
+
+    auto* cursor = (const uint8_t*)buffer;
+    size_t first_block_size = min_of(size, m_capacity - wrap(head));
+
+    memcpy(m_buffer + wrap(head), cursor, first_block_size);
+    memcpy(m_buffer, cursor + first_block_size, size - first_block_size);
+
+    // NOTE: publishes the copied bytes to the consumer
+    m_control->head.store(head + size, std::memory_order_release);
+    return true;
+}
+
+size_t SpscRingBuffer::size() const {
+    if (m_control == nullptr) return 0;
+
+    return m_control->head.load(std::memory_order_acquire) - m_control->tail.load(std::memory_order_relaxed);
+}
+
+size_t SpscRingBuffer::peek(void* buffer, size_t size) const {
+    size = min_of(size, this->size());
+    if (size == 0) return 0;
+
+    const size_t tail = m_control->tail.load(std::memory_order_relaxed);
+
+    auto* cursor = (uint8_t*)buffer;
+    size_t first_block_size = min_of(size, m_capacity - wrap(tail));
+
+    memcpy(cursor, m_buffer + wrap(tail), first_block_size);
+    memcpy(cursor + first_block_size, m_buffer, size - first_block_size);
+
+    return size;
+}
+
+size_t SpscRingBuffer::pop(void* buffer, size_t size) {
+    return consume(peek(buffer, size));
+}
+
+size_t SpscRingBuffer::consume(size_t size) {
+    size = min_of(size, this->size());
+    if (size == 0) return 0;
+
+    // NOTE: hands the space back to the producer, after all reads of it are done
+    m_control->tail.store(m_control->tail.load(std::memory_order_relaxed) + size, std::memory_order_release);
+    return size;
+}
+
+constexpr size_t OwnedSpscRingBuffer::s_default_capacity;
+
+OwnedSpscRingBuffer::OwnedSpscRingBuffer(size_t capacity) {
+    size_t rounded_capacity = s_cache_line_size;
+    while (rounded_capacity < capacity)
+        rounded_capacity *= 2;
+
+    m_storage = new uint8_t[rounded_capacity];
+    SpscRingBuffer::operator=(SpscRingBuffer{&m_owned_control, m_storage, rounded_capacity});
+}
+
+OwnedSpscRingBuffer::~OwnedSpscRingBuffer() {
+    delete[] m_storage;
+}
+
+}  // namespace iac
+
+#endif
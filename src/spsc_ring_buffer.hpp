@@ -0,0 +1,73 @@
+#pragma once
+
+#ifndef ARDUINO
+
+#    include <atomic>
+#    include <cstddef>
+#    include <cstdint>
+
+#    include "std_provider/string.hpp"
+#    include "std_provider/utility.hpp"
+
+namespace iac {
+
+// lock-free byte fifo for exactly one producing and one consuming thread (or process)
+// the storage is handed in, so both sides can live in shared memory, capacity has to be a power of two
+class SpscRingBuffer {
+   public:
+    static constexpr size_t s_cache_line_size = 64;
+
+    // NOTE: both counters only grow, their difference is the number of stored bytes
+    typedef struct control {
+        alignas(s_cache_line_size) std::atomic<size_t> head{0};  // bytes pushed so far, only written by the producer
+        alignas(s_cache_line_size) std::atomic<size_t> tail{0};  // bytes popped so far, only written by the consumer
+    } control_t;
+
+    SpscRingBuffer() = default;
+    SpscRingBuffer(control_t* control, uint8_t* buffer, size_t capacity);
+
+    size_t capacity() const {
+        return m_capacity;
+    };
+
+    // producer side
+    size_t free_space() const;
+    // pushes all bytes or nothing if they don't fit
+    bool push(const void* buffer, size_t size);
+
+    // consumer side
+    size_t size() const;
+    size_t peek(void* buffer, size_t size) const;
+    size_t pop(void* buffer, size_t size);
+    size_t consume(size_t size);
+
+   private:
+    size_t wrap(size_t index) const {
+        return index & (m_capacity - 1);
+    };
+
+    control_t* m_control{nullptr};
+    uint8_t* m_buffer{nullptr};
+    size_t m_capacity{0};
+};
+
+// SpscRingBuffer with its own storage, for threads of one process
+class OwnedSpscRingBuffer : public SpscRingBuffer {
+   public:
+    static constexpr size_t s_default_capacity = 1 << 18;
+
+    // `capacity` is rounded up to a power of two
+    explicit OwnedSpscRingBuffer(size_t capacity = s_default_capacity);
+    ~OwnedSpscRingBuffer();
+
+    OwnedSpscRingBuffer(const OwnedSpscRingBuffer&) = delete;
+    OwnedSpscRingBuffer& operator=(const OwnedSpscRingBuffer&) = delete;
+
+   private:
+    control_t m_owned_control{};
+    uint8_t* m_storage{nullptr};
+};
+
+}  // namespace iac
+
+#endif
@@ -0,0 +1,53 @@
+#include "timer_wheel.hpp"
+
+namespace iac {
+
+constexpr size_t TimerWheel::s_num_slots;
+constexpr uint64_t TimerWheel::s_tick_us;
+
+TimerWheel::TimerWheel() {
+    for (auto& slot : m_slots)
+        slot.m_prev = slot.m_next = &slot;
+}
+
+void TimerWheel::schedule(Timer& timer, timestamp deadline) {
+    cancel(timer);
+
+    // NOTE: deadlines in the past go into the slot of the current tick, which is visited again on the next advance
+    auto& slot = m_slots[max_of((size_t)(deadline.ts / s_tick_us), m_current_tick) % s_num_slots];
+
+    timer.m_deadline = deadline;
+    timer.m_prev = slot.m_prev;
+    timer.m_next = &slot;
+    slot.m_prev->m_next = &timer;
+    slot.m_prev = &timer;
+}
+
+void TimerWheel::cancel(Timer& timer) {
+    if (!timer.scheduled()) return;
+
+    timer.m_prev->m_next = timer.m_next;
+    timer.m_next->m_prev = timer.m_prev;
+    timer.m_prev = timer.m_next = nullptr;
+}
+
+void TimerWheel::advance(timestamp now) {
+    const size_t now_tick = now.ts / s_tick_us;
+
+    // NOTE: once a full turn passed every slot is visited once, timers which are more than a turn away stay in their slot
+    const size_t num_ticks = min_of(now_tick - m_current_tick, s_num_slots - 1) + 1;
+
+    for (size_t i = 0; i < num_ticks; i++) {
+        auto& slot = m_slots[(now_tick - i) % s_num_slots];
+
+        for (Timer* timer = slot.m_next; timer != &slot;) {
+            Timer* next = timer->m_next;
+            if (!(now < timer->m_deadline)) cancel(*timer);
+            timer = next;
+        }
+    }
+
+    m_current_tick = now_tick;
+}
+
+}  // namespace iac
\ No newline at end of file
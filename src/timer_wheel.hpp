@@ -0,0 +1,54 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+#include "network_types.hpp"
+#include "std_provider/utility.hpp"
+
+namespace iac {
+
+// hashed timer wheel, timers are sorted into slots by the tick of their deadline,
+// so advancing only visits the slots of the ticks which passed since the last advance
+// timers which expired are unscheduled, nothing else happens to them
+class TimerWheel {
+   public:
+    class Timer {
+        friend TimerWheel;
+
+       public:
+        bool scheduled() const {
+            return m_next != nullptr;
+        };
+
+        timestamp deadline() const {
+            return m_deadline;
+        };
+
+       private:
+        timestamp m_deadline{0};
+        Timer* m_prev{nullptr};
+        Timer* m_next{nullptr};
+    };
+
+    TimerWheel();
+
+    TimerWheel(const TimerWheel&) = delete;
+    TimerWheel& operator=(const TimerWheel&) = delete;
+
+    // (re-)schedules `timer` to expire once `deadline` is not in the future anymore
+    void schedule(Timer& timer, timestamp deadline);
+    void cancel(Timer& timer);
+
+    void advance(timestamp now);
+
+   private:
+    static constexpr size_t s_num_slots = 64;
+    static constexpr uint64_t s_tick_us = 16000;
+
+    // NOTE: every slot is the sentinel of a circular list, so linking and unlinking never branches
+    Timer m_slots[s_num_slots];
+    size_t m_current_tick{0};
+};
+
+}  // namespace iac
@@ -0,0 +1,83 @@
+#pragma once
+
+#include <cstring>
+#include <vector>
+
+#include "ftest/test_logging.hpp"
+#include "iac.hpp"
+#include "test_utilities.hpp"
+
+class TestBatchFraming {
+   public:
+    static TestLogging::test_result_t run() {
+        static constexpr int num_packages = 400;
+        static constexpr size_t large_payload_size = 300;
+
+        received_t received;
+
+        TEST_UTILS_CREATE_NODE_WITH_ENDPOINT(node1, ep1, "ep1", 1);
+        TEST_UTILS_CREATE_NODE_WITH_ENDPOINT(node2, ep2, "ep2", 2);
+
+        ep2.add_package_handler(0, pkg_handler, &received);
+        ep2.add_package_handler(1, pkg_handler, &received);
+
+        TEST_UTILS_CONNECT_NODES_WITH_LOOPBACK(tr1, node1, node2);
+        tr1.end1().route().set_batch_framing(true);
+        tr1.end2().route().set_receive_mode(iac::LocalTransportRoute::receive_mode::PAYLOAD_VIEW);
+
+        if (!TestUtilities::update_til_connected([] {}, node1, node2))
+            return {"nodes did not connect"};
+
+        // NOTE: network_update should arrive on next update
+        TestUtilities::update_all_nodes(node1, node2);
+
+        node1.set_output_coalescing(true);
+
+        uint8_t payload[large_payload_size];
+        TestUtilities::fill_payload(payload, large_payload_size);
+
+        // NOTE: small packages are batched, every large one goes out in its own frame behind them
+        size_t sent_payload_size = 0;
+        for (int i = 0; i < num_packages; ++i) {
+            size_t size = i % 50 == 49 ? large_payload_size : i % 16;
+            if (!node1.send(ep1, ep2.id(), i % 2, payload, size))
+                return {"failed to send pkg to ep2"};
+
+            sent_payload_size += size;
+            received.expected_sizes.push_back(size);
+        }
+
+        if (!node1.flush_now())
+            return {"failed to flush node1"};
+
+        size_t unbatched_size = sent_payload_size + num_packages * 7;
+        if (tr1.end2().route().connection().available() >= unbatched_size)
+            return {"batch frames were not smaller than single frames"};
+
+        if (!TestUtilities::update_until([&] { return received.count >= num_packages || received.error != nullptr; }, [] {}, node1, node2))
+            return {"not all packages arrived"};
+
+        if (received.error != nullptr)
+            return {received.error};
+
+        return {};
+    };
+
+   private:
+    typedef struct received {
+        std::vector<size_t> expected_sizes;
+        int count = 0;
+        const char* error = nullptr;
+    } received_t;
+
+    static void pkg_handler(const iac::Package& pkg, void* data) {
+        auto* received = (received_t*)data;
+
+        if (pkg.type() != received->count % 2 || pkg.payload_size() != received->expected_sizes[received->count])
+            received->error = "packages arrived out of order";
+
+        if (!TestUtilities::payload_intact(pkg.payload(), pkg.payload_size())) received->error = "received corrupt payload";
+
+        received->count++;
+    };
+};
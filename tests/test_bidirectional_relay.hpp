@@ -0,0 +1,102 @@
+#pragma once
+
+#include "ftest/test_logging.hpp"
+#include "iac.hpp"
+#include "test_utilities.hpp"
+
+class TestBidirectionalRelay {
+   public:
+    static TestLogging::test_result_t run() {
+        static constexpr uint32_t num_packages = 200;
+        static constexpr size_t receive_window = 2048;
+        static constexpr size_t high_watermark = 1024;
+        static constexpr size_t bytes_per_update = 256;
+        static constexpr int max_num_updates = 20000;
+
+        received_t received1, received3;
+
+        TEST_UTILS_CREATE_NODE_WITH_ENDPOINT(node1, ep1, "ep1", 1);
+        TEST_UTILS_CREATE_NODE_WITH_ENDPOINT(node2, ep2, "ep2", 2);
+        TEST_UTILS_CREATE_NODE_WITH_ENDPOINT(node3, ep3, "ep3", 3);
+
+        ep1.add_package_handler(0, pkg_handler, &received1);
+        ep3.add_package_handler(0, pkg_handler, &received3);
+
+        // NOTE: node1 and node3 send to each other through node2, every route is flow controlled
+        //       and both routes of the relay only take a few bytes per update
+        iac::LoopbackConnectionPackage<ThrottledLoopbackConnection> tr1;
+        iac::LoopbackConnectionPackage<ThrottledLoopbackConnection> tr2;
+
+        auto& relay_to_node1 = tr1.end2().route();
+        auto& relay_to_node3 = tr2.end1().route();
+        auto& throttled_to_node1 = (ThrottledLoopbackConnection&)relay_to_node1.connection();
+        auto& throttled_to_node3 = (ThrottledLoopbackConnection&)relay_to_node3.connection();
+
+        for (auto* route : {&tr1.end1().route(), &relay_to_node1, &relay_to_node3, &tr2.end2().route()}) {
+            route->set_receive_window(receive_window);
+            route->set_high_watermark(high_watermark);
+        }
+
+        tr1.connect(node1, node2);
+        tr2.connect(node2, node3);
+
+        int num_updates = 0;
+
+        auto update = [&] {
+            throttled_to_node1.set_budget(bytes_per_update);
+            throttled_to_node3.set_budget(bytes_per_update);
+            TestUtilities::update_all_nodes(node1, node2, node3);
+        };
+
+        while (!node1.endpoint_connected(ep3.id()) || !node3.endpoint_connected(ep1.id())) {
+            if (num_updates++ > max_num_updates)
+                return {"nodes did not connect"};
+            update();
+        }
+
+        uint8_t payload[payload_size]{};
+
+        uint32_t next_package1 = 0, next_package3 = 0;
+
+        auto send_all = [&](iac::LocalNode& node, iac::LocalEndpoint& from, iac::ep_id_t to, uint32_t& next_package) {
+            while (next_package < num_packages) {
+                memcpy(payload, &next_package, sizeof(next_package));
+                if (!node.send(from, to, 0, payload, payload_size)) break;
+                next_package++;
+            }
+        };
+
+        while (received1.count < num_packages || received3.count < num_packages) {
+            if (num_updates++ > max_num_updates)
+                return {"relay stopped making progress"};
+
+            send_all(node1, ep1, ep3.id(), next_package1);
+            send_all(node3, ep3, ep1.id(), next_package3);
+
+            update();
+        }
+
+        if (received1.out_of_order || received3.out_of_order)
+            return {"relay dropped or reordered packages"};
+
+        if (!node1.all_routes_connected() || !node2.all_routes_connected() || !node3.all_routes_connected())
+            return {"route was closed while saturated"};
+
+        return {};
+    };
+
+   private:
+    static constexpr size_t payload_size = 100;
+
+    typedef struct received {
+        uint32_t count = 0;
+        bool out_of_order = false;
+    } received_t;
+
+    static void pkg_handler(const iac::Package& pkg, iac::BufferReader&& reader, void* data) {
+        auto* received = (received_t*)data;
+
+        if (pkg.payload_size() != payload_size || reader.num<uint32_t>() != received->count) received->out_of_order = true;
+        received->count++;
+    };
+};
@@ -0,0 +1,80 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <thread>
+
+#include "ftest/test_logging.hpp"
+#include "iac.hpp"
+#include "test_utilities.hpp"
+
+class TestConcurrentLoopback {
+   public:
+    static TestLogging::test_result_t run() {
+        using namespace std::chrono_literals;
+
+        static constexpr int num_packages = 5000;
+        static constexpr size_t max_payload_size = 1500;
+
+        received_t received;
+        std::atomic<bool> sender_failed{false};
+
+        TEST_UTILS_CREATE_NODE_WITH_ENDPOINT(node1, ep1, "ep1", 1);
+        TEST_UTILS_CREATE_NODE_WITH_ENDPOINT(node2, ep2, "ep2", 2);
+
+        ep2.add_package_handler(0, pkg_handler, &received);
+
+        iac::LoopbackConnectionPackage<iac::ConcurrentLoopbackConnection> loopback;
+        loopback.connect(node1, node2);
+
+        const auto deadline = std::chrono::steady_clock::now() + 10s;
+        auto timed_out = [&] { return std::chrono::steady_clock::now() > deadline; };
+
+        // NOTE: every node is only touched by its own thread from here on
+        std::thread sender{[&] {
+            uint8_t payload[max_payload_size];
+            TestUtilities::fill_payload(payload, max_payload_size);
+
+            while (!node1.endpoint_connected(ep2.id()) && !timed_out())
+                node1.update();
+
+            for (int i = 0; i < num_packages && !timed_out();) {
+                // NOTE: a full queue rejects the package, it is sent again after the receiver caught up
+                if (node1.send(ep1, ep2.id(), 0, payload, TestUtilities::varying_payload_size(i, max_payload_size))) i++;
+                node1.update();
+            }
+
+            while (received.count < num_packages && !timed_out())
+                node1.update();
+
+            sender_failed = received.count < num_packages;
+        }};
+
+        while (received.count < num_packages && !timed_out())
+            node2.update();
+
+        sender.join();
+
+        if (sender_failed || received.count < num_packages)
+            return {"not all packages arrived"};
+
+        if (received.corrupt)
+            return {"received corrupt payload"};
+
+        return {};
+    };
+
+   private:
+    typedef struct received {
+        std::atomic<int> count{0};
+        std::atomic<bool> corrupt{false};
+    } received_t;
+
+    static void pkg_handler(const iac::Package& pkg, void* data) {
+        auto* received = (received_t*)data;
+
+        if (!TestUtilities::payload_intact(pkg.payload(), pkg.payload_size())) received->corrupt = true;
+
+        received->count++;
+    };
+};
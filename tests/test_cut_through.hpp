@@ -0,0 +1,81 @@
+#pragma once
+
+#include <cstring>
+
+#include "ftest/test_logging.hpp"
+#include "iac.hpp"
+#include "test_utilities.hpp"
+
+class TestCutThrough {
+   public:
+    static TestLogging::test_result_t run() {
+        static constexpr int num_packages = 300;
+
+        received_t received;
+
+        TEST_UTILS_CREATE_NODE_WITH_ENDPOINT(node1, ep1, "ep1", 1);
+        TEST_UTILS_CREATE_NODE_WITH_ENDPOINT(node2, ep2, "ep2", 2);
+        TEST_UTILS_CREATE_NODE_WITH_ENDPOINT(node3, ep3, "ep3", 3);
+
+        ep3.add_package_handler(0, pkg_handler, &received);
+
+        // NOTE: frames which fit through the small frames of node3 are relayed as they are,
+        //       the others are decoded by node2 and sent on in fragments
+        TEST_UTILS_CONNECT_NODES_WITH_LOOPBACK(tr1, node1, node2);
+        TEST_UTILS_CONNECT_NODES_WITH_LOOPBACK(tr2, node2, node3);
+        tr2.end2().route().set_max_frame_size(s_small_frame_size);
+
+        if (!TestUtilities::update_til_connected([] {}, node1, node2, node3))
+            return {"nodes did not connect"};
+
+        if (!TestUtilities::update_until([&] { return node1.endpoint_connected(ep3.id()); }, [] {}, node1, node2, node3))
+            return {"endpoint of node3 did not reach node1"};
+
+        uint8_t payload[s_large_payload_size];
+        TestUtilities::fill_payload(payload, s_large_payload_size);
+
+        for (int i = 0; i < num_packages; ++i) {
+            memcpy(payload, &i, sizeof(i));
+
+            size_t size = i % 10 == 9 ? s_large_payload_size : sizeof(i) + (i * 37) % 400;
+            if (!node1.send(ep1, ep3.id(), 0, payload, size))
+                return {"failed to send pkg to ep3"};
+        }
+
+        if (!TestUtilities::update_until([&] { return received.count >= num_packages; }, [] {}, node1, node2, node3))
+            return {"not all packages arrived"};
+
+        if (received.error != nullptr)
+            return {received.error};
+
+        return {};
+    };
+
+   private:
+    static constexpr size_t s_small_frame_size = 512;
+    static constexpr size_t s_large_payload_size = 900;
+
+    typedef struct received {
+        int count = 0;
+        int last_relayed_index = -1;
+        const char* error = nullptr;
+    } received_t;
+
+    static void pkg_handler(const iac::Package& pkg, void* data) {
+        auto* received = (received_t*)data;
+
+        int index = 0;
+        memcpy(&index, pkg.payload(), sizeof(index));
+
+        for (size_t i = sizeof(index); i < pkg.payload_size(); ++i)
+            if (pkg.payload()[i] != (uint8_t)i) received->error = "received corrupt payload";
+
+        // NOTE: fragmented packages can be overtaken, the ones relayed as they are keep their order
+        if (pkg.payload_size() < s_large_payload_size) {
+            if (index <= received->last_relayed_index) received->error = "relayed packages arrived out of order";
+            received->last_relayed_index = index;
+        }
+
+        received->count++;
+    };
+};
@@ -1,8 +1,6 @@
 #pragma once
 
-#include <chrono>
 #include <exception>
-#include <thread>
 
 #include "ftest/test_logging.hpp"
 #include "iac.hpp"
@@ -12,30 +10,34 @@
 class TestDisconnectReconnect {
    public:
     static TestLogging::test_result_t run() {
-        using namespace std::chrono_literals;
-
         int rec_pkg_count = 0;
 
+        // NOTE: timeouts are reached in virtual time, so the test does not have to wait for them
+        iac::VirtualClock clock;
+
         TEST_UTILS_CREATE_NODE_WITH_ENDPOINT(node1, ep1, "ep1", 1);
         TEST_UTILS_CREATE_NODE_WITH_ENDPOINT(node2, ep2, "ep2", 2);
 
         ep1.add_package_handler(0, pkg_handler, &rec_pkg_count);
         ep2.add_package_handler(0, pkg_handler, &rec_pkg_count);
 
+        node1.set_clock(&clock);
+        node2.set_clock(&clock);
+
         TEST_UTILS_CONNECT_NODES_WITH_LOOPBACK(tr1, node1, node2);
 
         try {
             for (int i = 0; i < 2; ++i) {
-                TestUtilities::update_til_connected([] {}, node1, node2);
+                if (!TestUtilities::update_til_connected([] {}, node1, node2))
+                    return {"nodes did not connect"};
 
                 node1.network().print_network();
                 node2.network().print_network();
 
-                while (node1.endpoint_connected(2)) {
-                    node1.update();
-                }
+                if (!TestUtilities::update_until([&] { return !node1.endpoint_connected(2); }, [&clock] { clock.advance_ms(1); }, node1))
+                    return {"silent route did not time out"};
 
-                std::this_thread::sleep_for(200ms);
+                clock.advance_ms(200);
             }
         } catch (std::exception& e) {
             return {e.what()};
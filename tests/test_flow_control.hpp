@@ -0,0 +1,110 @@
+#pragma once
+
+#include "ftest/test_logging.hpp"
+#include "iac.hpp"
+#include "test_utilities.hpp"
+
+class TestFlowControl {
+   public:
+    static TestLogging::test_result_t run() {
+        static constexpr uint32_t num_packages = 300;
+        static constexpr size_t receive_window = 2048;
+        static constexpr size_t high_watermark = 1024;
+        static constexpr size_t bytes_per_update = 256;
+        static constexpr int max_num_updates = 20000;
+
+        received_t received;
+
+        TEST_UTILS_CREATE_NODE_WITH_ENDPOINT(node1, ep1, "ep1", 1);
+        TEST_UTILS_CREATE_NODE_WITH_ENDPOINT(node2, ep2, "ep2", 2);
+        TEST_UTILS_CREATE_NODE_WITH_ENDPOINT(node3, ep3, "ep3", 3);
+
+        ep3.add_package_handler(0, pkg_handler, &received);
+
+        // NOTE: packages to ep3 are relayed by node2, whose route towards node3 only takes a few bytes per update
+        iac::LoopbackConnectionPackage<iac::LoopbackConnection> tr1;
+        iac::LoopbackConnectionPackage<ThrottledLoopbackConnection> tr2;
+
+        auto& relay_in = tr1.end2().route();
+        auto& relay_out = tr2.end1().route();
+        auto& throttled = (ThrottledLoopbackConnection&)relay_out.connection();
+
+        relay_in.set_receive_window(receive_window);
+        relay_out.set_high_watermark(high_watermark);
+
+        tr1.connect(node1, node2);
+        tr2.connect(node2, node3);
+
+        int num_updates = 0;
+
+        while (!node1.endpoint_connected(ep3.id()) || !node3.endpoint_connected(ep1.id())) {
+            if (num_updates++ > max_num_updates)
+                return {"nodes did not connect"};
+
+            throttled.set_budget(bytes_per_update);
+            TestUtilities::update_all_nodes(node1, node2, node3);
+        }
+
+        if (!tr1.end1().route().flow_controlled())
+            return {"receive window was not announced"};
+
+        uint8_t payload[payload_size]{};
+
+        uint32_t next_package = 0;
+        int num_rejected = 0;
+        size_t max_pending = 0, max_queued = 0;
+
+        // NOTE: node1 sends as much as it is allowed to, everything it got rid of has to arrive
+        while (received.count < num_packages) {
+            if (num_updates++ > max_num_updates)
+                return {"not all packages arrived"};
+
+            while (next_package < num_packages) {
+                memcpy(payload, &next_package, sizeof(next_package));
+                if (!node1.send(ep1, ep3.id(), 0, payload, payload_size)) {
+                    num_rejected++;
+                    break;
+                }
+                next_package++;
+            }
+
+            max_pending = iac::max_of(max_pending, relay_in.connection().available());
+            max_queued = iac::max_of(max_queued, relay_out.outbound_size());
+
+            throttled.set_budget(bytes_per_update);
+            TestUtilities::update_all_nodes(node1, node2, node3);
+        }
+
+        if (received.out_of_order)
+            return {"relay dropped or reordered packages"};
+
+        if (num_rejected == 0)
+            return {"sender never ran out of credit"};
+
+        // NOTE: the window can be exceeded by a frame which was admitted with credit left, and by control packages
+        if (max_pending > receive_window + 2 * payload_size)
+            return {"sender exceeded its receive window"};
+
+        if (max_queued > high_watermark + 2 * payload_size)
+            return {"relay queued past its high watermark"};
+
+        TestLogging::test_printf("at most %d bytes pending at the relay and %d bytes queued by it", (int)max_pending, (int)max_queued);
+
+        return {};
+    };
+
+   private:
+    static constexpr size_t payload_size = 200;
+
+    typedef struct received {
+        uint32_t count = 0;
+        bool out_of_order = false;
+    } received_t;
+
+    static void pkg_handler(const iac::Package& pkg, iac::BufferReader&& reader, void* data) {
+        auto* received = (received_t*)data;
+
+        if (pkg.payload_size() != payload_size || reader.num<uint32_t>() != received->count) received->out_of_order = true;
+        received->count++;
+    };
+};
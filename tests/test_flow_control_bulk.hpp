@@ -0,0 +1,102 @@
+#pragma once
+
+#include "ftest/test_logging.hpp"
+#include "iac.hpp"
+#include "test_utilities.hpp"
+
+class TestFlowControlBulk {
+   public:
+    static TestLogging::test_result_t run() {
+        static constexpr uint32_t num_packages = 150;
+        static constexpr size_t receive_window = 2048;
+        static constexpr size_t high_watermark = 1024;
+        static constexpr size_t bytes_per_update_in = 128;
+        static constexpr size_t bytes_per_update_out = 64;
+        static constexpr int max_num_updates = 20000;
+
+        uint32_t num_received = 0;
+
+        iac::VirtualClock clock;
+
+        TEST_UTILS_CREATE_NODE_WITH_ENDPOINT(node1, ep1, "ep1", 1);
+        TEST_UTILS_CREATE_NODE_WITH_ENDPOINT(node2, ep2, "ep2", 2);
+        TEST_UTILS_CREATE_NODE_WITH_ENDPOINT(node3, ep3, "ep3", 3);
+
+        node1.set_clock(&clock);
+        node2.set_clock(&clock);
+        node3.set_clock(&clock);
+
+        ep3.add_package_handler(0, pkg_handler, &num_received);
+
+        // NOTE: node1 can write more than the relay gets rid of, but only a few bytes per update as well,
+        //       so its bulk packages queue up on its route while heartbeats overtake them
+        iac::LoopbackConnectionPackage<ThrottledLoopbackConnection> tr1;
+        iac::LoopbackConnectionPackage<ThrottledLoopbackConnection> tr2;
+
+        auto& sender = tr1.end1().route();
+        auto& relay_in = tr1.end2().route();
+        auto& relay_out = tr2.end1().route();
+        auto& throttled_in = (ThrottledLoopbackConnection&)sender.connection();
+        auto& throttled_out = (ThrottledLoopbackConnection&)relay_out.connection();
+
+        relay_in.set_receive_window(receive_window);
+        relay_out.set_high_watermark(high_watermark);
+
+        tr1.connect(node1, node2);
+        tr2.connect(node2, node3);
+
+        int num_updates = 0;
+
+        auto update = [&] {
+            throttled_in.set_budget(bytes_per_update_in);
+            throttled_out.set_budget(bytes_per_update_out);
+            TestUtilities::update_all_nodes(node1, node2, node3);
+            clock.advance_ms(ms_per_update);
+        };
+
+        while (!node1.endpoint_connected(ep3.id()) || !node3.endpoint_connected(ep1.id())) {
+            if (num_updates++ > max_num_updates)
+                return {"nodes did not connect"};
+            update();
+        }
+
+        uint8_t payload[payload_size]{};
+
+        uint32_t next_package = 0;
+        size_t max_pending = 0, max_queued = 0;
+
+        while (num_received < num_packages) {
+            if (num_updates++ > max_num_updates)
+                return {"not all packages arrived"};
+
+            while (next_package < num_packages &&
+                   node1.send(ep1, ep3.id(), 0, payload, payload_size, iac::Package::buffer_management::IN_PLACE, iac::package_priority::BULK))
+                next_package++;
+
+            max_pending = iac::max_of(max_pending, relay_in.connection().available() + relay_in.held_size());
+            max_queued = iac::max_of(max_queued, sender.outbound_size(iac::package_priority::BULK));
+
+            update();
+        }
+
+        if (max_queued == 0)
+            return {"bulk packages never queued at the sender"};
+
+        // NOTE: heartbeats which overtook the queued packages must not let the sender write past the window
+        if (max_pending > receive_window + 2 * payload_size)
+            return {"sender exceeded its receive window"};
+
+        TestLogging::test_printf("at most %d bytes pending at the relay while %d bytes queued at the sender", (int)max_pending, (int)max_queued);
+
+        return {};
+    };
+
+   private:
+    static constexpr size_t payload_size = 200;
+    // NOTE: heartbeats are due after a few updates without output, while the sender still works off its queue
+    static constexpr size_t ms_per_update = 20;
+
+    static void pkg_handler(const iac::Package& pkg, void* data) {
+        (*(uint32_t*)data)++;
+    };
+};
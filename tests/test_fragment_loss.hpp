@@ -0,0 +1,190 @@
+#pragma once
+
+#include <vector>
+
+#include "ftest/test_logging.hpp"
+#include "iac.hpp"
+#include "test_utilities.hpp"
+
+// passes every frame on as one datagram, except for a fragment which is chosen to be lost or duplicated
+class LossyLoopbackConnection : public iac::LoopbackConnection {
+   public:
+    enum class fault {
+        LOSE,
+        DUPLICATE
+    };
+
+    using iac::LoopbackConnection::LoopbackConnection;
+
+    size_t write_vectored(const io_vector_t* vectors, size_t count) override {
+        size_t total_size = 0;
+        for (size_t i = 0; i < count; i++)
+            total_size += vectors[i].size;
+
+        // NOTE: the metadata follows the start byte and the package size
+        uint8_t metadata = 0;
+        if (vectors[0].size > s_metadata_offset) metadata = ((const uint8_t*)vectors[0].buffer)[s_metadata_offset];
+
+        if ((metadata & s_fragment_flag) == 0) return iac::LoopbackConnection::write_vectored(vectors, count);
+
+        m_num_fragments++;
+        if (m_fragments_until_fault-- != 0) return iac::LoopbackConnection::write_vectored(vectors, count);
+
+        if (m_fault == fault::LOSE) return total_size;
+
+        iac::LoopbackConnection::write_vectored(vectors, count);
+        return iac::LoopbackConnection::write_vectored(vectors, count);
+    };
+
+    bool datagram_oriented() const override {
+        return true;
+    };
+
+    // the `n`th fragment written from now on is lost or written twice
+    void inject(fault fault, int n) {
+        m_fault = fault;
+        m_fragments_until_fault = n;
+    };
+
+    int num_fragments() const {
+        return m_num_fragments;
+    };
+
+   private:
+    static constexpr size_t s_metadata_offset = 3;
+    static constexpr uint8_t s_fragment_flag = 1 << 1;
+
+    fault m_fault{fault::LOSE};
+    int m_fragments_until_fault = -1;
+    int m_num_fragments = 0;
+};
+
+class TestFragmentLoss {
+   public:
+    static TestLogging::test_result_t run() {
+        static constexpr size_t frame_size = 128;
+        static constexpr int max_num_updates = 2000;
+
+        received_t received;
+
+        iac::VirtualClock clock;
+
+        TEST_UTILS_CREATE_NODE_WITH_ENDPOINT(node1, ep1, "ep1", 1);
+        TEST_UTILS_CREATE_NODE_WITH_ENDPOINT(node2, ep2, "ep2", 2);
+
+        node1.set_clock(&clock);
+        node2.set_clock(&clock);
+
+        ep2.add_package_handler(0, pkg_handler, &received);
+
+        iac::LoopbackConnectionPackage<LossyLoopbackConnection> tr;
+        tr.end1().route().set_max_frame_size(frame_size);
+        tr.connect(node1, node2);
+
+        auto& route = tr.end1().route();
+        auto& lossy = (LossyLoopbackConnection&)route.connection();
+
+        int num_updates = 0;
+
+        auto update = [&] {
+            TestUtilities::update_all_nodes(node1, node2);
+            clock.advance_ms(ms_per_update);
+        };
+
+        while (!node1.endpoint_connected(ep2.id()) || !node2.endpoint_connected(ep1.id())) {
+            if (num_updates++ > max_num_updates)
+                return {"nodes did not connect"};
+            update();
+        }
+
+        std::vector<uint8_t> payload(payload_size);
+
+        // NOTE: sends a package and updates until all of its fragments were written and read
+        auto transfer = [&](uint8_t value) {
+            for (auto& byte : payload)
+                byte = value;
+
+            if (!node1.send(ep1, ep2.id(), 0, payload.data(), payload.size())) return false;
+
+            do {
+                if (num_updates++ > max_num_updates) return false;
+                update();
+            } while (route.has_outgoing_transfers());
+
+            update();
+            return true;
+        };
+
+        if (!transfer(1)) return {"failed to transfer package"};
+
+        const int num_fragments = lossy.num_fragments();
+        if (received.count != 1 || num_fragments < 3) return {"package was not sent in fragments"};
+
+        // NOTE: a duplicate must neither complete the transfer early nor deliver it twice
+        lossy.inject(LossyLoopbackConnection::fault::DUPLICATE, 1);
+        if (!transfer(2)) return {"failed to transfer package"};
+
+        if (received.count != 2) return {"duplicated fragment broke the transfer"};
+        if (received.corrupt) return {"duplicated fragment completed the transfer with a hole"};
+
+        // NOTE: a transfer with a hole is dropped, instead of completing once enough bytes arrived
+        lossy.inject(LossyLoopbackConnection::fault::LOSE, 1);
+        if (!transfer(3)) return {"failed to transfer package"};
+
+        if (received.count != 2) return {"transfer with lost fragment was delivered"};
+
+        // NOTE: transfers whose last fragment is lost would take up all reassembly slots for good
+        for (size_t i = 0; i < iac::LocalTransportRoute::s_num_reassembly_slots; ++i) {
+            lossy.inject(LossyLoopbackConnection::fault::LOSE, num_fragments - 1);
+            if (!transfer(4)) return {"failed to transfer package"};
+        }
+
+        if (received.count != 2) return {"transfer with lost fragment was delivered"};
+
+        for (int i = 0; i < idle_updates; ++i)
+            update();
+
+        if (!transfer(5)) return {"failed to transfer package"};
+
+        if (received.count != 3) return {"reassembly slots of lost transfers were never freed"};
+
+        // NOTE: more transfers than the other side has reassembly slots for are sent one after another
+        for (size_t i = 0; i < 2 * iac::LocalTransportRoute::s_num_reassembly_slots; ++i)
+            if (!node1.send(ep1, ep2.id(), 0, payload.data(), payload.size())) return {"failed to send package"};
+
+        while (route.has_outgoing_transfers()) {
+            if (num_updates++ > max_num_updates)
+                return {"interleaved transfers were never sent"};
+            update();
+        }
+        update();
+
+        if (received.count != 3 + 2 * (int)iac::LocalTransportRoute::s_num_reassembly_slots)
+            return {"interleaved transfers did not fit into the reassembly slots"};
+
+        if (received.corrupt) return {"received corrupt payload"};
+
+        return {};
+    };
+
+   private:
+    static constexpr size_t payload_size = 1000;
+    static constexpr size_t ms_per_update = 10;
+    static constexpr int idle_updates = 100;
+
+    typedef struct received {
+        int count = 0;
+        bool corrupt = false;
+    } received_t;
+
+    static void pkg_handler(const iac::Package& pkg, void* data) {
+        auto* received = (received_t*)data;
+
+        if (pkg.payload_size() != payload_size) received->corrupt = true;
+
+        for (size_t i = 0; i < pkg.payload_size(); ++i)
+            if (pkg.payload()[i] != pkg.payload()[0]) received->corrupt = true;
+
+        received->count++;
+    };
+};
@@ -0,0 +1,88 @@
+#pragma once
+
+#include <vector>
+
+#include "ftest/test_logging.hpp"
+#include "iac.hpp"
+#include "test_utilities.hpp"
+
+class TestFragmentation {
+   public:
+    static TestLogging::test_result_t run() {
+        static constexpr int num_small_packages = 5;
+        static constexpr size_t small_frame_size = 128;
+
+        received_t received;
+
+        TEST_UTILS_CREATE_NODE_WITH_ENDPOINT(node1, ep1, "ep1", 1);
+        TEST_UTILS_CREATE_NODE_WITH_ENDPOINT(node2, ep2, "ep2", 2);
+        TEST_UTILS_CREATE_NODE_WITH_ENDPOINT(node3, ep3, "ep3", 3);
+
+        ep3.add_package_handler(0, small_handler, &received);
+        ep3.add_package_handler(1, large_handler, &received);
+
+        // NOTE: node2 reassembles the package and fragments it again for the small frames of node3
+        TEST_UTILS_CONNECT_NODES_WITH_LOOPBACK(tr1, node1, node2);
+        TEST_UTILS_CONNECT_NODES_WITH_LOOPBACK(tr2, node2, node3);
+        tr2.end2().route().set_max_frame_size(small_frame_size);
+
+        if (!TestUtilities::update_til_connected([] {}, node1, node2, node3))
+            return {"nodes did not connect"};
+
+        if (!TestUtilities::update_until([&] { return node1.endpoint_connected(ep3.id()); }, [] {}, node1, node2, node3))
+            return {"endpoint of node3 did not reach node1"};
+
+        if (tr2.end1().route().frame_size_limit() != small_frame_size)
+            return {"frame size was not negotiated"};
+
+        std::vector<uint8_t> payload(large_payload_size);
+        for (size_t i = 0; i < large_payload_size; ++i)
+            payload[i] = i * 7;
+
+        if (!node1.send(ep1, ep3.id(), 1, payload.data(), payload.size()))
+            return {"failed to send large pkg to ep3"};
+
+        for (int i = 0; i < num_small_packages; ++i) {
+            if (!node1.send(ep1, ep3.id(), 0, (const uint8_t*)&i, sizeof(i)))
+                return {"failed to send small pkg to ep3"};
+        }
+
+        if (!TestUtilities::update_until([&] { return received.large_count > 0; }, [] {}, node1, node2, node3))
+            return {"large package did not arrive"};
+
+        if (received.error != nullptr)
+            return {received.error};
+
+        if (received.small_count_before_large != num_small_packages)
+            return {"small packages were blocked by the large one"};
+
+        return {};
+    };
+
+   private:
+    static constexpr size_t large_payload_size = 200000;
+
+    typedef struct received {
+        int small_count = 0;
+        int small_count_before_large = 0;
+        int large_count = 0;
+        const char* error = nullptr;
+    } received_t;
+
+    static void small_handler(const iac::Package& pkg, void* data) {
+        ((received_t*)data)->small_count++;
+    };
+
+    static void large_handler(const iac::Package& pkg, void* data) {
+        auto* received = (received_t*)data;
+
+        if (pkg.payload_size() != large_payload_size)
+            received->error = "large package has wrong size";
+
+        for (size_t i = 0; i < pkg.payload_size(); ++i)
+            if (pkg.payload()[i] != (uint8_t)(i * 7)) received->error = "received corrupt payload";
+
+        received->small_count_before_large = received->small_count;
+        received->large_count++;
+    };
+};
@@ -0,0 +1,39 @@
+#pragma once
+
+#include "ftest/test_logging.hpp"
+#include "iac.hpp"
+#include "test_utilities.hpp"
+
+class TestHandshakeOrder {
+   public:
+    static TestLogging::test_result_t run() {
+        static constexpr int max_num_updates = 10;
+
+        // NOTE: time stands still, so no part of the handshake is sent again
+        iac::VirtualClock clock;
+
+        TEST_UTILS_CREATE_NODE_WITH_ENDPOINT(node1, ep1, "ep1", 1);
+        TEST_UTILS_CREATE_NODE_WITH_ENDPOINT(node2, ep2, "ep2", 2);
+
+        node1.set_clock(&clock);
+        node2.set_clock(&clock);
+
+        TEST_UTILS_CONNECT_NODES_WITH_LOOPBACK(tr, node1, node2);
+
+        // NOTE: node2 gets through its part of the handshake first, so node1 reads its connect and its ack
+        //       from the stream within the same update
+        if (!node1.update()) return {"update failed"};
+        if (!node2.update() || !node2.update()) return {"update failed"};
+
+        for (int i = 0; i < max_num_updates; ++i)
+            if (!node1.update() || !node2.update()) return {"ack which arrived along with the connect broke the update"};
+
+        if (!node1.all_routes_connected() || !node2.all_routes_connected())
+            return {"ack which arrived along with the connect was lost"};
+
+        if (!node1.endpoint_connected(ep2.id()) || !node2.endpoint_connected(ep1.id()))
+            return {"endpoints were not exchanged"};
+
+        return {};
+    };
+};
@@ -0,0 +1,112 @@
+#pragma once
+
+#include <map>
+#include <set>
+
+#include "ftest/test_logging.hpp"
+#include "iac.hpp"
+
+class TestIdMap {
+   public:
+    static TestLogging::test_result_t run() {
+        iac::DenseIdMap<uint8_t, int> dense;
+        iac::HashedIdMap<uint16_t, int> hashed;
+        std::map<uint8_t, int> dense_reference;
+        std::map<uint16_t, int> hashed_reference;
+
+        iac::IdBitset<uint8_t> bitset;
+        iac::InlineIdMap<uint16_t, int, 4> inline_map;
+        std::set<uint8_t> bitset_reference;
+        std::map<uint16_t, int> inline_reference;
+
+        // NOTE: random churn, so erased slots get reused and the hashed map rehashes several times
+        uint32_t state = 12345;
+        auto next_random = [&state]() {
+            state = state * 1103515245 + 12345;
+            return state >> 8;
+        };
+
+        for (int i = 0; i < 20000; ++i) {
+            uint16_t key = next_random() % 600;
+            int value = next_random();
+
+            if (next_random() % 3 == 0) {
+                if (hashed.erase(key) != hashed_reference.erase(key)) return {"hashed erase mismatch"};
+                if (dense.erase(key % 256) != dense_reference.erase(key % 256)) return {"dense erase mismatch"};
+                if (bitset.erase(key % 256) != bitset_reference.erase(key % 256)) return {"bitset erase mismatch"};
+                if (inline_map.erase(key % 40) != inline_reference.erase(key % 40)) return {"inline erase mismatch"};
+            } else {
+                // NOTE: inserting keeps existing entries, like std::map::insert
+                inline_map.insert({(uint16_t)(key % 40), value});
+                inline_reference.insert({key % 40, value});
+                bitset.insert(key % 256);
+                bitset_reference.insert(key % 256);
+
+                hashed[key] = value;
+                hashed_reference[key] = value;
+                dense[key % 256] = value;
+                dense_reference[key % 256] = value;
+            }
+        }
+
+        if (hashed.size() != hashed_reference.size() || dense.size() != dense_reference.size() ||
+            bitset.size() != bitset_reference.size() || inline_map.size() != inline_reference.size())
+            return {"size mismatch"};
+
+        // NOTE: both compact containers iterate in key order
+        auto bitset_reference_it = bitset_reference.begin();
+        for (auto key : bitset)
+            if (key != *bitset_reference_it++) return {"bitset entry mismatch"};
+
+        auto inline_copy = inline_map;
+        auto inline_reference_it = inline_reference.begin();
+        for (const auto& entry : inline_copy) {
+            if (entry.first != inline_reference_it->first || entry.second != inline_reference_it->second) return {"inline entry mismatch"};
+            inline_reference_it++;
+        }
+
+        size_t num_iterated = 0;
+        for (const auto& entry : hashed) {
+            auto res = hashed_reference.find(entry.first);
+            if (res == hashed_reference.end() || res->second != entry.second) return {"hashed entry mismatch"};
+            num_iterated++;
+        }
+
+        for (const auto& entry : dense) {
+            auto res = dense_reference.find(entry.first);
+            if (res == dense_reference.end() || res->second != entry.second) return {"dense entry mismatch"};
+            num_iterated++;
+        }
+
+        if (num_iterated != hashed_reference.size() + dense_reference.size())
+            return {"iteration skipped entries"};
+
+        for (uint16_t key = 0; key < 600; ++key) {
+            bool registered = hashed_reference.find(key) != hashed_reference.end();
+            if ((hashed.find(key) != hashed.end()) != registered) return {"hashed find mismatch"};
+            if (registered && hashed.at(key) != hashed_reference[key]) return {"hashed at mismatch"};
+        }
+
+        // NOTE: like unordered_map::at, missing keys raise an exception instead of handing out a value
+        bool hashed_missing_raised = false, dense_missing_raised = false;
+
+        hashed.erase(600);
+        try {
+            hashed.at(600) = 1;
+        } catch (const iac::IdMapMissingKeyException&) {
+            hashed_missing_raised = true;
+        }
+
+        dense.erase(255);
+        try {
+            dense.at(255) = 1;
+        } catch (const iac::IdMapMissingKeyException&) {
+            dense_missing_raised = true;
+        }
+
+        if (!hashed_missing_raised || !dense_missing_raised) return {"at() with missing key did not raise"};
+        if (dense[255] != 0) return {"write through at() showed up in inserted entry"};
+
+        return {};
+    };
+};
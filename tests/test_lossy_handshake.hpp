@@ -0,0 +1,91 @@
+#pragma once
+
+#include "ftest/test_logging.hpp"
+#include "iac.hpp"
+#include "test_utilities.hpp"
+
+class TestLossyHandshake {
+   public:
+    static TestLogging::test_result_t run() {
+        if (!connects(iac::reserved_package_types::CONNECT))
+            return {"handshake did not recover from a lost connect"};
+
+        if (!connects(iac::reserved_package_types::ACK))
+            return {"handshake did not recover from a lost ack"};
+
+        return {};
+    };
+
+   private:
+    static constexpr uint64_t step_ms = 5;
+    // NOTE: well below the time after which a silent route is closed and the handshake starts over
+    static constexpr uint64_t max_connect_time_ms = 1000;
+
+    // loses the first frame of the handshake with `type` which node1 writes, all other frames pass
+    class HandshakeLossConnection : public iac::LoopbackConnection {
+       public:
+        using iac::LoopbackConnection::LoopbackConnection;
+
+        size_t write_vectored(const io_vector_t* vectors, size_t count) override {
+            size_t total_size = 0;
+            for (size_t i = 0; i < count; i++)
+                total_size += vectors[i].size;
+
+            // NOTE: the receiver follows the start byte, the package size and the metadata, the type follows the sender
+            static constexpr size_t to_offset = 4;
+            static constexpr size_t type_offset = 6;
+
+            const auto* header = (const uint8_t*)vectors[0].buffer;
+
+            if (m_lose && vectors[0].size > type_offset && header[to_offset] == iac::reserved_endpoint_addresses::IAC && header[type_offset] == m_lost_type) {
+                m_lose = false;
+                return total_size;
+            }
+
+            return iac::LoopbackConnection::write_vectored(vectors, count);
+        };
+
+        void lose(iac::package_type_t type) {
+            m_lost_type = type;
+            m_lose = true;
+        };
+
+        bool lost() const {
+            return !m_lose;
+        };
+
+       private:
+        iac::package_type_t m_lost_type{0};
+        bool m_lose{false};
+    };
+
+    static bool connects(iac::package_type_t lost_type) {
+        iac::VirtualClock clock;
+
+        TEST_UTILS_CREATE_NODE_WITH_ENDPOINT(node1, ep1, "ep1", 1);
+        TEST_UTILS_CREATE_NODE_WITH_ENDPOINT(node2, ep2, "ep2", 2);
+
+        node1.set_clock(&clock);
+        node2.set_clock(&clock);
+
+        iac::LoopbackConnectionPackage<HandshakeLossConnection> tr;
+        auto& lossy = (HandshakeLossConnection&)tr.end1().route().connection();
+        lossy.lose(lost_type);
+
+        tr.end1().route().meta().timings = {100, 3000};
+        tr.end2().route().meta().timings = {100, 3000};
+
+        tr.connect(node1, node2);
+
+        for (uint64_t elapsed_ms = 0; elapsed_ms < max_connect_time_ms; elapsed_ms += step_ms) {
+            TestUtilities::update_all_nodes(node1, node2);
+            clock.advance_ms(step_ms);
+
+            if (lossy.lost() && node1.endpoint_connected(ep2.id()) && node2.endpoint_connected(ep1.id()) &&
+                node1.all_routes_connected() && node2.all_routes_connected())
+                return true;
+        }
+
+        return false;
+    };
+};
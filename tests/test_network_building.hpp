@@ -19,7 +19,8 @@ class TestNetworkBuilding {
 
         TestLogging::test_printf("node1 network rep on startup %s", node1.network().network_representation().c_str());
 
-        TestUtilities::update_til_connected([] {}, node1, node2, node3, node4);
+        if (!TestUtilities::update_til_connected([] {}, node1, node2, node3, node4))
+            return {"nodes did not connect"};
 
         for (int i = 0; i < 5; ++i)
             TestUtilities::update_all_nodes(node1, node2, node3, node4);
@@ -0,0 +1,77 @@
+#pragma once
+
+#include "ftest/test_logging.hpp"
+#include "iac.hpp"
+#include "test_utilities.hpp"
+
+class TestNextHopCache {
+   public:
+    static TestLogging::test_result_t run() {
+        static constexpr int num_packages = 20;
+        static constexpr int max_num_updates = 2000;
+
+        int received = 0;
+
+        TEST_UTILS_CREATE_NODE_WITH_ENDPOINT(node1, ep1, "ep1", 1);
+        TEST_UTILS_CREATE_NODE_WITH_ENDPOINT(node2, ep2, "ep2", 2);
+        TEST_UTILS_CREATE_NODE_WITH_ENDPOINT(node3, ep3, "ep3", 3);
+
+        ep3.add_package_handler(0, pkg_handler, &received);
+
+        // NOTE: node1 reaches node3 over a direct route and through node2, the direct route is one hop shorter
+        iac::LoopbackConnectionPackage<iac::LoopbackConnection> direct;
+        iac::LoopbackConnectionPackage<ThrottledLoopbackConnection> tr1;
+        TEST_UTILS_CONNECT_NODES_WITH_LOOPBACK(tr2, node2, node3);
+
+        direct.connect(node1, node3);
+        tr1.connect(node1, node2);
+
+        auto& relayed = (ThrottledLoopbackConnection&)tr1.end1().route().connection();
+
+        int num_updates = 0;
+        uint8_t payload[16]{};
+
+        auto wait_for = [&](auto condition) {
+            while (!condition()) {
+                if (num_updates++ > max_num_updates) return false;
+                TestUtilities::update_all_nodes(node1, node2, node3);
+            }
+            return true;
+        };
+
+        // NOTE: packages only arrive in time if node1 picks a route which currently leads to node3
+        auto deliver = [&] {
+            const int expected = received + num_packages;
+
+            for (int i = 0; i < num_packages; ++i)
+                if (!node1.send(ep1, ep3.id(), 0, payload, sizeof(payload))) return false;
+
+            for (int i = 0; i < 100 && received < expected; ++i)
+                TestUtilities::update_all_nodes(node1, node2, node3);
+
+            return received == expected;
+        };
+
+        if (!wait_for([&] { return TestUtilities::all_nodes_connected(node1, node2, node3) && node1.endpoints_connected({ep2.id(), ep3.id()}); }))
+            return {"nodes did not connect"};
+
+        // NOTE: the route through node2 takes nothing, so the direct route has to be the next hop
+        relayed.set_budget(0);
+
+        if (!deliver()) return {"packages did not take the shortest route"};
+
+        relayed.set_budget(iac::numeric_limits<size_t>::max());
+
+        node1.remove_local_transport_route(direct.end1().route());
+        node3.remove_local_transport_route(direct.end2().route());
+
+        if (!deliver()) return {"next hop still pointed at the dropped route"};
+
+        return {};
+    };
+
+   private:
+    static void pkg_handler(const iac::Package& pkg, void* data) {
+        (*(int*)data)++;
+    };
+};
@@ -0,0 +1,90 @@
+#pragma once
+
+#include <chrono>
+
+#include "ftest/test_logging.hpp"
+#include "iac.hpp"
+#include "test_utilities.hpp"
+
+class TestOutboundQueue {
+   public:
+    static TestLogging::test_result_t run() {
+        using namespace std::chrono_literals;
+
+        static constexpr int max_num_packages = 10000;
+
+        TestUtilities::received_t received;
+        int writable_count = 0;
+
+        TEST_UTILS_CREATE_NODE_WITH_ENDPOINT(node1, ep1, "ep1", 1);
+        TEST_UTILS_CREATE_NODE_WITH_ENDPOINT(node2, ep2, "ep2", 2);
+
+        ep1.add_package_handler(0, pkg_handler, &received);
+        node2.set_writable_handler(writable_handler, &writable_count);
+
+        iac::LocalTransportRoutePackage<iac::UnixSocketServerConnection> server{s_path, iac::SocketConnection::read_mode::BUFFERED};
+        iac::LocalTransportRoutePackage<iac::UnixSocketClientConnection> client{s_path, iac::SocketConnection::read_mode::BUFFERED};
+
+        if (!server.connection())
+            return {"failed to set up unix socket"};
+
+        node1.add_local_transport_route(server);
+        node2.add_local_transport_route(client);
+
+        client.route().set_high_watermark(4 * payload_size);
+
+        auto deadline = std::chrono::steady_clock::now() + 5s;
+
+        while (!node1.endpoint_connected(ep2.id()) || !node2.endpoint_connected(ep1.id())) {
+            if (std::chrono::steady_clock::now() > deadline)
+                return {"nodes did not connect"};
+            TestUtilities::update_all_nodes(node1, node2);
+        }
+
+        uint8_t payload[payload_size];
+        TestUtilities::fill_payload(payload, payload_size);
+
+        // NOTE: node1 doesn't read, so the socket fills up and node2 has to queue until it hits the watermark
+        int num_accepted = 0;
+        while (num_accepted < max_num_packages && node2.send(ep2, ep1.id(), 0, payload, payload_size))
+            num_accepted++;
+
+        if (num_accepted == max_num_packages)
+            return {"sending never blocked"};
+
+        if (node2.writable(ep1.id()))
+            return {"blocked route reports writable"};
+
+        while (received.count < num_accepted || writable_count == 0) {
+            if (std::chrono::steady_clock::now() > deadline)
+                return {"queued packages did not arrive"};
+            TestUtilities::update_all_nodes(node1, node2);
+        }
+
+        if (received.count != num_accepted)
+            return {"received more packages than were accepted"};
+
+        if (received.corrupt)
+            return {"received corrupt payload"};
+
+        if (!node2.writable(ep1.id()) || client.route().outbound_size() != 0)
+            return {"route did not drain"};
+
+        return {};
+    };
+
+   private:
+    static constexpr const char* s_path = "/tmp/iac-test-outbound-queue";
+    static constexpr size_t payload_size = 1500;
+
+    static void pkg_handler(const iac::Package& pkg, void* data) {
+        // NOTE: queued packages must neither be cut nor merged
+        if (pkg.payload_size() != payload_size) ((TestUtilities::received_t*)data)->corrupt = true;
+
+        TestUtilities::count_received(pkg, data);
+    };
+
+    static void writable_handler(iac::LocalNode& node, void* counter) {
+        (*(int*)counter)++;
+    };
+};
@@ -0,0 +1,97 @@
+#pragma once
+
+#include <chrono>
+
+#include "ftest/test_logging.hpp"
+#include "iac.hpp"
+#include "test_utilities.hpp"
+
+class TestOutputCoalescing {
+   public:
+    static TestLogging::test_result_t run() {
+        using namespace std::chrono_literals;
+
+        static constexpr int num_packages = 50;
+
+        TEST_UTILS_CREATE_NODE_WITH_ENDPOINT(node1, ep1, "ep1", 1);
+        TEST_UTILS_CREATE_NODE_WITH_ENDPOINT(node2, ep2, "ep2", 2);
+
+        replier_t replier{node1, ep1};
+        int reply_count = 0;
+
+        ep1.add_package_handler(0, reply_handler, &replier);
+        ep2.add_package_handler(1, count_handler, &reply_count);
+
+        iac::LocalTransportRoutePackage<iac::UnixSocketServerConnection> server{s_path, iac::SocketConnection::read_mode::BUFFERED};
+        iac::LocalTransportRoutePackage<iac::UnixSocketClientConnection> client{s_path, iac::SocketConnection::read_mode::BUFFERED};
+
+        if (!server.connection())
+            return {"failed to set up unix socket"};
+
+        node1.add_local_transport_route(server);
+        node2.add_local_transport_route(client);
+
+        node1.set_output_coalescing(true);
+        node2.set_output_coalescing(true);
+
+        auto deadline = std::chrono::steady_clock::now() + 5s;
+
+        while (!node1.endpoint_connected(ep2.id()) || !node2.endpoint_connected(ep1.id())) {
+            if (std::chrono::steady_clock::now() > deadline)
+                return {"nodes did not connect"};
+            TestUtilities::update_all_nodes(node1, node2);
+        }
+
+        for (int i = 0; i < num_packages; ++i) {
+            if (!node2.send(ep2, ep1.id(), 0, (const uint8_t*)&i, sizeof(i)))
+                return {"failed to send pkg to ep1"};
+        }
+
+        // NOTE: nothing leaves node2 before it is flushed
+        for (int i = 0; i < 10; ++i)
+            node1.update();
+
+        if (replier.count != 0)
+            return {"coalesced output was written before flushing"};
+
+        if (!node2.flush_now())
+            return {"failed to flush node2"};
+
+        // NOTE: node1 replies from inside its handlers, the replies go out together at the end of the update
+        while (replier.count < num_packages || reply_count < num_packages) {
+            if (std::chrono::steady_clock::now() > deadline)
+                return {"not all packages arrived"};
+            TestUtilities::update_all_nodes(node1, node2);
+        }
+
+        if (replier.out_of_order)
+            return {"packages arrived out of order"};
+
+        return {};
+    };
+
+   private:
+    static constexpr const char* s_path = "/tmp/iac-test-output-coalescing";
+
+    typedef struct replier {
+        iac::LocalNode& node;
+        iac::LocalEndpoint& ep;
+        int count = 0;
+        bool out_of_order = false;
+    } replier_t;
+
+    static void reply_handler(const iac::Package& pkg, void* data) {
+        auto* replier = (replier_t*)data;
+
+        int index;
+        memcpy(&index, pkg.payload(), sizeof(index));
+        if (index != replier->count) replier->out_of_order = true;
+
+        replier->count++;
+        replier->node.send(replier->ep, pkg.from(), 1, pkg.payload(), pkg.payload_size());
+    };
+
+    static void count_handler(const iac::Package& pkg, void* counter) {
+        (*(int*)counter)++;
+    };
+};
@@ -0,0 +1,73 @@
+#pragma once
+
+#include "ftest/test_logging.hpp"
+#include "iac.hpp"
+#include "test_utilities.hpp"
+
+class TestPackageHandlers {
+   public:
+    static TestLogging::test_result_t run() {
+        received_t received;
+
+        TEST_UTILS_CREATE_NODE_WITH_ENDPOINT(node1, ep1, "ep1", 1);
+        TEST_UTILS_CREATE_NODE_WITH_ENDPOINT(node2, ep2, "ep2", 2);
+
+        ep2.add_package_handler<0, static_handler>(&received);
+        ep2.add_package_handler<1, reader_handler>(&received);
+        ep2.add_package_handler(2, [&received](const iac::Package&) { received.by_fn++; });
+
+        // NOTE: registering a handler again replaces the previous one
+        ep2.add_package_handler(3, [&received](const iac::Package&) { received.replaced++; });
+        ep2.add_package_handler(3, dynamic_handler, &received);
+
+        ep2.add_package_handler(4, dynamic_handler, &received);
+        if (!ep2.remove_package_handler(4) || ep2.remove_package_handler(5))
+            return {"removing handlers did not report registered handlers"};
+
+        TEST_UTILS_CONNECT_NODES_WITH_LOOPBACK(tr1, node1, node2);
+        if (!TestUtilities::update_til_connected([] {}, node1, node2))
+            return {"nodes did not connect"};
+
+        // NOTE: network_update should arrive on next update
+        TestUtilities::update_all_nodes(node1, node2);
+
+        uint32_t value = s_value;
+        for (iac::package_type_t type = 0; type < 5; type++)
+            if (!node1.send(ep1, ep2.id(), type, (const uint8_t*)&value, sizeof(value)))
+                return {"failed to send pkg to ep2"};
+
+        for (int i = 0; i < 10; ++i)
+            TestUtilities::update_all_nodes(node1, node2);
+
+        if (received.by_static != 1 || received.by_reader != 1 || received.by_fn != 1)
+            return {"packages did not reach their handlers"};
+
+        if (received.replaced != 0 || received.by_dynamic != 1)
+            return {"replaced or removed handler was called"};
+
+        return {};
+    };
+
+   private:
+    static constexpr uint32_t s_value = 0xC0FFEE;
+
+    typedef struct received {
+        int by_static = 0;
+        int by_reader = 0;
+        int by_fn = 0;
+        int by_dynamic = 0;
+        int replaced = 0;
+    } received_t;
+
+    static void static_handler(const iac::Package& pkg, void* data) {
+        ((received_t*)data)->by_static++;
+    };
+
+    static void reader_handler(const iac::Package& pkg, iac::BufferReader&& reader, void* data) {
+        if (reader.num<uint32_t>() == s_value) ((received_t*)data)->by_reader++;
+    };
+
+    static void dynamic_handler(const iac::Package& pkg, void* data) {
+        ((received_t*)data)->by_dynamic++;
+    };
+};
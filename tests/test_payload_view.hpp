@@ -0,0 +1,60 @@
+#pragma once
+
+#include <cstring>
+#include <vector>
+
+#include "ftest/test_logging.hpp"
+#include "iac.hpp"
+#include "test_utilities.hpp"
+
+class TestPayloadView {
+   public:
+    static TestLogging::test_result_t run() {
+        received_t received;
+
+        TEST_UTILS_CREATE_NODE_WITH_ENDPOINT(node1, ep1, "ep1", 1);
+        TEST_UTILS_CREATE_NODE_WITH_ENDPOINT(node2, ep2, "ep2", 2);
+
+        ep2.add_package_handler(0, pkg_handler, &received);
+
+        TEST_UTILS_CONNECT_NODES_WITH_LOOPBACK(tr1, node1, node2);
+        tr1.end1().route().set_receive_mode(iac::LocalTransportRoute::receive_mode::PAYLOAD_VIEW);
+        tr1.end2().route().set_receive_mode(iac::LocalTransportRoute::receive_mode::PAYLOAD_VIEW);
+
+        if (!TestUtilities::update_til_connected([] {}, node1, node2))
+            return {"nodes did not connect"};
+
+        // NOTE: network_update should arrive on next update
+        TestUtilities::update_all_nodes(node1, node2);
+
+        const char* payloads[] = {"first payload", "second payload"};
+
+        for (const auto* payload : payloads)
+            if (!node1.send(ep1, ep2.id(), 0, (const uint8_t*)payload, strlen(payload) + 1))
+                return {"failed to send pkg to ep2"};
+
+        if (!TestUtilities::update_until([&] { return received.packages.size() >= 2; }, [] {}, node1, node2))
+            return {"not all packages arrived"};
+
+        if (received.views[0] != received.views[1])
+            return {"payloads were not placed in the receive buffer of the route"};
+
+        for (size_t i = 0; i < 2; ++i)
+            if (strcmp((const char*)received.packages[i].payload(), payloads[i]) != 0)
+                return {"retained payload did not match sent payload"};
+
+        return {};
+    };
+
+   private:
+    typedef struct received {
+        std::vector<const uint8_t*> views;
+        std::vector<iac::Package> packages;
+    } received_t;
+
+    static void pkg_handler(const iac::Package& pkg, void* data) {
+        auto* received = (received_t*)data;
+        received->views.push_back(pkg.payload());
+        received->packages.push_back(pkg.retain());
+    };
+};
@@ -0,0 +1,107 @@
+#pragma once
+
+#include <vector>
+
+#include "ftest/test_logging.hpp"
+#include "iac.hpp"
+#include "test_utilities.hpp"
+
+class TestPriorityClasses {
+   public:
+    static TestLogging::test_result_t run() {
+        static constexpr uint32_t num_bulk_packages = 40;
+        static constexpr uint32_t num_interactive_packages = 4;
+        static constexpr size_t bytes_per_update = 256;
+        static constexpr int max_num_updates = 2000;
+
+        std::vector<uint8_t> arrivals;
+
+        iac::VirtualClock clock;
+
+        TEST_UTILS_CREATE_NODE_WITH_ENDPOINT(node1, ep1, "ep1", 1);
+        TEST_UTILS_CREATE_NODE_WITH_ENDPOINT(node2, ep2, "ep2", 2);
+
+        node1.set_clock(&clock);
+        node2.set_clock(&clock);
+
+        ep2.add_package_handler(0, pkg_handler, &arrivals);
+
+        iac::LoopbackConnectionPackage<ThrottledLoopbackConnection> tr;
+        tr.connect(node1, node2);
+
+        auto& route = tr.end1().route();
+        auto& throttled = (ThrottledLoopbackConnection&)route.connection();
+
+        int num_updates = 0;
+
+        while (!node1.endpoint_connected(ep2.id()) || !node2.endpoint_connected(ep1.id())) {
+            if (num_updates++ > max_num_updates)
+                return {"nodes did not connect"};
+
+            TestUtilities::update_all_nodes(node1, node2);
+            clock.advance_ms(1);
+        }
+
+        // NOTE: from here on node1 only gets a few bytes out per update, the bulk packages queue up on its route
+        throttled.set_budget(0);
+
+        uint8_t payload[payload_size]{};
+
+        payload[0] = bulk;
+        for (uint32_t i = 0; i < num_bulk_packages; ++i)
+            if (!node1.send(ep1, ep2.id(), 0, payload, payload_size, iac::Package::buffer_management::IN_PLACE, iac::package_priority::BULK))
+                return {"bulk package was rejected"};
+
+        payload[0] = interactive;
+        for (uint32_t i = 0; i < num_interactive_packages; ++i)
+            if (!node1.send(ep1, ep2.id(), 0, payload, payload_size))
+                return {"interactive package was rejected"};
+
+        if (route.outbound_size(iac::package_priority::BULK) == 0 || route.outbound_size(iac::package_priority::INTERACTIVE) == 0)
+            return {"packages were not queued by class"};
+
+        // NOTE: a heartbeat is due, it has to leave with the next update instead of waiting behind the bulk packages
+        clock.advance_ms(route.meta().timings.heartbeat_interval_ms + 1);
+        node1.update();
+
+        if (route.outbound_size(iac::package_priority::CONTROL) == 0)
+            return {"heartbeat was not queued as control package"};
+
+        throttled.set_budget(bytes_per_update);
+        node1.update();
+
+        if (route.outbound_size(iac::package_priority::CONTROL) != 0)
+            return {"heartbeat waited behind other packages"};
+
+        while (arrivals.size() < num_bulk_packages + num_interactive_packages) {
+            if (num_updates++ > max_num_updates)
+                return {"not all packages arrived"};
+
+            throttled.set_budget(bytes_per_update);
+            TestUtilities::update_all_nodes(node1, node2);
+            clock.advance_ms(1);
+        }
+
+        if (!node1.all_routes_connected() || !node2.all_routes_connected())
+            return {"route was closed while saturated"};
+
+        // NOTE: interactive packages overtake the queued bulk packages, only one frame which was started goes first
+        size_t last_interactive = 0;
+        for (size_t i = 0; i < arrivals.size(); ++i)
+            if (arrivals[i] == interactive) last_interactive = i;
+
+        if (last_interactive > num_interactive_packages)
+            return {"interactive packages waited behind bulk packages"};
+
+        return {};
+    };
+
+   private:
+    static constexpr size_t payload_size = 100;
+    static constexpr uint8_t bulk = 1;
+    static constexpr uint8_t interactive = 2;
+
+    static void pkg_handler(const iac::Package& pkg, void* data) {
+        ((std::vector<uint8_t>*)data)->push_back(pkg.payload()[0]);
+    };
+};
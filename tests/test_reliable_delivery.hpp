@@ -0,0 +1,122 @@
+#pragma once
+
+#include <vector>
+
+#include "ftest/test_logging.hpp"
+#include "iac.hpp"
+#include "test_utilities.hpp"
+
+class TestReliableDelivery {
+   public:
+    static TestLogging::test_result_t run() {
+        static constexpr uint32_t num_packages = 300;
+        static constexpr uint64_t step_ms = 5;
+        static constexpr uint64_t max_duration_ms = 60000;
+
+        std::vector<int> received(num_packages, 0);
+
+        // NOTE: retransmissions are driven by virtual time, so the test runs as fast as the nodes can update
+        iac::VirtualClock clock;
+
+        TEST_UTILS_CREATE_NODE_WITH_ENDPOINT(node1, ep1, "ep1", 1);
+        TEST_UTILS_CREATE_NODE_WITH_ENDPOINT(node2, ep2, "ep2", 2);
+        TEST_UTILS_CREATE_NODE_WITH_ENDPOINT(node3, ep3, "ep3", 3);
+
+        node1.set_clock(&clock);
+        node2.set_clock(&clock);
+        node3.set_clock(&clock);
+
+        ep3.add_package_handler(0, pkg_handler, &received);
+
+        // NOTE: packages to ep3 are relayed by node2, both hops lose frames
+        iac::LoopbackConnectionPackage<LossyLoopbackConnection> tr1;
+        iac::LoopbackConnectionPackage<LossyLoopbackConnection> tr2;
+        tr1.connect(node1, node2);
+        tr2.connect(node2, node3);
+
+        if (!TestUtilities::update_until([&] { return node1.endpoint_connected(ep3.id()) && node3.endpoint_connected(ep1.id()); },
+                                         [&clock] { clock.advance_ms(step_ms); }, node1, node2, node3))
+            return {"nodes did not connect"};
+
+        node1.set_reliable_delivery(0, true);
+
+        uint32_t next_package = 0;
+        uint64_t elapsed_ms = 0;
+
+        auto all_received = [&received] {
+            for (auto count : received)
+                if (count == 0) return false;
+            return true;
+        };
+
+        // NOTE: sends are rejected while the window is full, the package is offered again on the next update
+        while (next_package < num_packages || !all_received()) {
+            if (elapsed_ms > max_duration_ms)
+                return {"not all packages arrived"};
+
+            while (next_package < num_packages && node1.send(ep1, ep3.id(), 0, (const uint8_t*)&next_package, sizeof(next_package)))
+                next_package++;
+
+            TestUtilities::update_all_nodes(node1, node2, node3);
+            clock.advance_ms(step_ms);
+            elapsed_ms += step_ms;
+        }
+
+        for (auto count : received)
+            if (count != 1) return {"package was delivered more than once"};
+
+        const size_t num_dropped = tr1.end1().connection().num_dropped() + tr1.end2().connection().num_dropped() +
+                                   tr2.end1().connection().num_dropped() + tr2.end2().connection().num_dropped();
+
+        if (num_dropped == 0)
+            return {"lossy connections did not drop any frames"};
+
+        TestLogging::test_printf("delivered %d packages in %d ms of virtual time with %d dropped frames", (int)num_packages, (int)elapsed_ms, (int)num_dropped);
+
+        return {};
+    };
+
+   private:
+    // drops about every fifth package and ack which is delivered reliably, all other frames pass
+    class LossyLoopbackConnection : public iac::LoopbackConnection {
+       public:
+        using iac::LoopbackConnection::LoopbackConnection;
+
+        size_t write_vectored(const io_vector_t* vectors, size_t count) override {
+            // NOTE: the metadata byte follows the start byte and the package size
+            static constexpr size_t metadata_offset = 3;
+            static constexpr uint8_t reliable_flags = (1 << 2) | (1 << 3);
+
+            const auto* header = (const uint8_t*)vectors[0].buffer;
+
+            // NOTE: a fixed pseudo random sequence, as a periodic pattern can keep hitting the same retransmission
+            m_random_state = m_random_state * 1103515245 + 12345;
+
+            if (vectors[0].size > metadata_offset && (header[metadata_offset] & reliable_flags) && (m_random_state >> 16) % 5 == 0) {
+                size_t size = 0;
+                for (size_t i = 0; i < count; ++i)
+                    size += vectors[i].size;
+
+                m_num_dropped++;
+                return size;
+            }
+
+            return iac::LoopbackConnection::write_vectored(vectors, count);
+        };
+
+        size_t num_dropped() const {
+            return m_num_dropped;
+        };
+
+       private:
+        uint32_t m_random_state = 12345;
+        size_t m_num_dropped = 0;
+    };
+
+    static void pkg_handler(const iac::Package& pkg, iac::BufferReader&& reader, void* data) {
+        auto& received = *(std::vector<int>*)data;
+
+        const auto index = reader.num<uint32_t>();
+        if (index < received.size()) received[index]++;
+    };
+};
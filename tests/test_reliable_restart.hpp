@@ -0,0 +1,87 @@
+#pragma once
+
+#include <vector>
+
+#include "ftest/test_logging.hpp"
+#include "iac.hpp"
+#include "test_utilities.hpp"
+
+class TestReliableRestart {
+   public:
+    static TestLogging::test_result_t run() {
+        static constexpr uint32_t num_packages_per_run = 5;
+        static constexpr uint64_t step_ms = 5;
+        static constexpr int max_num_updates = 2000;
+
+        std::vector<int> received(2 * num_packages_per_run, 0);
+
+        iac::VirtualClock clock;
+
+        TEST_UTILS_CREATE_NODE_WITH_ENDPOINT(node1, ep1, "ep1", 1);
+        TEST_UTILS_CREATE_NODE_WITH_ENDPOINT(node2, ep2, "ep2", 2);
+
+        // NOTE: the same endpoint on a node which takes over once the first one is gone, as after a restart
+        TEST_UTILS_CREATE_NODE_WITH_ENDPOINT(restarted_node1, restarted_ep1, "ep1", 1);
+
+        node1.set_clock(&clock);
+        node2.set_clock(&clock);
+        restarted_node1.set_clock(&clock);
+
+        ep2.add_package_handler(0, pkg_handler, &received);
+
+        node1.set_reliable_delivery(0, true);
+        restarted_node1.set_reliable_delivery(0, true);
+
+        int num_updates = 0;
+
+        // NOTE: sends the packages of one run and updates until all of them were acknowledged
+        auto send_run = [&](iac::LocalNode& node, iac::LocalEndpoint& ep, uint32_t first_package) {
+            while (!node.endpoint_connected(ep2.id()) || !node2.endpoint_connected(ep1.id())) {
+                if (num_updates++ > max_num_updates) return false;
+
+                TestUtilities::update_all_nodes(node, node2);
+                clock.advance_ms(step_ms);
+            }
+
+            for (uint32_t i = first_package; i < first_package + num_packages_per_run; ++i)
+                if (!node.send(ep, ep2.id(), 0, (const uint8_t*)&i, sizeof(i))) return false;
+
+            for (int i = 0; i < 20; ++i) {
+                TestUtilities::update_all_nodes(node, node2);
+                clock.advance_ms(step_ms);
+            }
+
+            return true;
+        };
+
+        iac::LoopbackConnectionPackage<iac::LoopbackConnection> tr1;
+        tr1.connect(node1, node2);
+
+        if (!send_run(node1, ep1, 0)) return {"first run failed to send"};
+
+        for (uint32_t i = 0; i < num_packages_per_run; ++i)
+            if (received[i] != 1) return {"package of first run was not delivered"};
+
+        node1.remove_local_transport_route(tr1.end1().route());
+        node2.remove_local_transport_route(tr1.end2().route());
+
+        // NOTE: the sequences of the restarted node start over, below the ones node2 expects next
+        iac::LoopbackConnectionPackage<iac::LoopbackConnection> tr2;
+        tr2.connect(restarted_node1, node2);
+
+        if (!send_run(restarted_node1, restarted_ep1, num_packages_per_run)) return {"second run failed to send"};
+
+        for (uint32_t i = num_packages_per_run; i < 2 * num_packages_per_run; ++i)
+            if (received[i] != 1) return {"package of restarted node was taken as duplicate"};
+
+        return {};
+    };
+
+   private:
+    static void pkg_handler(const iac::Package& pkg, iac::BufferReader&& reader, void* data) {
+        auto& received = *(std::vector<int>*)data;
+
+        const auto index = reader.num<uint32_t>();
+        if (index < received.size()) received[index]++;
+    };
+};
@@ -0,0 +1,111 @@
+#pragma once
+
+#include <deque>
+#include <vector>
+
+#include "ftest/test_logging.hpp"
+#include "iac.hpp"
+
+class TestRingBuffer {
+   public:
+    static TestLogging::test_result_t run() {
+        iac::RingBuffer buffer;
+        std::deque<uint8_t> reference;
+
+        uint32_t state = 12345;
+        auto next_random = [&state]() {
+            state = state * 1103515245 + 12345;
+            return state >> 8;
+        };
+
+        uint8_t next_byte = 0;
+        std::vector<uint8_t> data(4096);
+
+        bool wrapped_growth = false;
+
+        // NOTE: random pushes and partial consumes, so the stored bytes wrap around and the buffer grows while wrapped
+        for (int i = 0; i < 20000; ++i) {
+            const size_t size = next_random() % (i % 1000 < 500 ? 300 : 60);
+
+            switch (next_random() % 5) {
+                case 0:
+                case 1: {
+                    for (size_t j = 0; j < size; ++j)
+                        data[j] = next_byte++;
+
+                    const size_t capacity = buffer.capacity();
+                    size_t contiguous_size = 0;
+                    if (buffer.size() > 0) buffer.front(contiguous_size);
+                    const bool wrapped = contiguous_size < buffer.size();
+
+                    buffer.push(data.data(), size);
+                    reference.insert(reference.end(), data.begin(), data.begin() + size);
+
+                    if (wrapped && buffer.capacity() > capacity) wrapped_growth = true;
+                    break;
+                }
+
+                case 2: {
+                    // NOTE: writes through back() in as many contiguous blocks as it hands out
+                    size_t written_size = 0;
+                    while (written_size < size) {
+                        size_t contiguous_size = 0;
+                        uint8_t* block = buffer.back(size - written_size, contiguous_size);
+                        if (contiguous_size == 0) return {"back returned no space"};
+
+                        const size_t block_size = iac::min_of(contiguous_size, size - written_size);
+                        for (size_t j = 0; j < block_size; ++j) {
+                            block[j] = next_byte;
+                            reference.push_back(next_byte++);
+                        }
+
+                        buffer.commit(block_size);
+                        written_size += block_size;
+                    }
+                    break;
+                }
+
+                case 3: {
+                    const size_t peeked_size = buffer.peek(data.data(), size);
+                    if (peeked_size != iac::min_of(size, reference.size())) return {"peek size mismatch"};
+
+                    for (size_t j = 0; j < peeked_size; ++j)
+                        if (data[j] != reference[j]) return {"peeked byte mismatch"};
+
+                    if (buffer.consume(size / 2) != iac::min_of(size / 2, reference.size())) return {"consume size mismatch"};
+                    reference.erase(reference.begin(), reference.begin() + iac::min_of(size / 2, reference.size()));
+                    break;
+                }
+
+                case 4: {
+                    size_t contiguous_size = 0;
+                    const uint8_t* front = buffer.front(contiguous_size);
+                    if (contiguous_size > reference.size() || (contiguous_size == 0 && !reference.empty())) return {"front size mismatch"};
+
+                    for (size_t j = 0; j < contiguous_size; ++j)
+                        if (front[j] != reference[j]) return {"front byte mismatch"};
+
+                    const size_t popped_size = buffer.pop(data.data(), size);
+                    if (popped_size != iac::min_of(size, reference.size())) return {"pop size mismatch"};
+
+                    for (size_t j = 0; j < popped_size; ++j)
+                        if (data[j] != reference[j]) return {"popped byte mismatch"};
+
+                    reference.erase(reference.begin(), reference.begin() + popped_size);
+                    break;
+                }
+            }
+
+            if (buffer.size() != reference.size()) return {"size mismatch"};
+            if (buffer.capacity() & (buffer.capacity() - 1)) return {"capacity is no power of two"};
+        }
+
+        if (!wrapped_growth)
+            return {"buffer never grew while wrapped"};
+
+        buffer.clear();
+        if (!buffer.empty() || buffer.peek(data.data(), 1) != 0) return {"clear left data behind"};
+
+        return {};
+    };
+};
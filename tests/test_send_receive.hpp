@@ -19,7 +19,8 @@ class TestSendReceive {
 
         TEST_UTILS_CONNECT_NODES_WITH_LOOPBACK(tr1, node1, node2);
 
-        TestUtilities::update_til_connected([] {}, node1, node2);
+        if (!TestUtilities::update_til_connected([] {}, node1, node2))
+            return {"nodes did not connect"};
 
         // NOTE: network_update should arrive on next update
         TestUtilities::update_all_nodes(node1, node2);
@@ -28,15 +29,15 @@ class TestSendReceive {
             return {"failed to send pkg to ep2"};
         }
 
-        while (rec_pkg_count < 1)
-            TestUtilities::update_all_nodes(node1, node2);
+        if (!TestUtilities::update_until([&] { return rec_pkg_count >= 1; }, [] {}, node1, node2))
+            return {"pkg to ep2 did not arrive"};
 
         if (!node2.send(ep2, ep1.id(), 0, nullptr, 0)) {
             return {"failed to send pkg to ep1"};
         }
 
-        while (rec_pkg_count < 2)
-            TestUtilities::update_all_nodes(node1, node2);
+        if (!TestUtilities::update_until([&] { return rec_pkg_count >= 2; }, [] {}, node1, node2))
+            return {"pkg to ep1 did not arrive"};
 
         TestLogging::test_printf("node1 %s", node1.network().network_representation(false).c_str());
         TestLogging::test_printf("node2 %s", node2.network().network_representation(false).c_str());
@@ -0,0 +1,83 @@
+#pragma once
+
+#include <chrono>
+
+#include "ftest/test_logging.hpp"
+#include "iac.hpp"
+#include "test_utilities.hpp"
+
+class TestSharedMemory {
+   public:
+    static TestLogging::test_result_t run() {
+        using namespace std::chrono_literals;
+
+        static constexpr int num_packages = 200;
+        static constexpr size_t max_payload_size = 1500;
+        static constexpr int poll_timeout_ms = 10;
+
+        TestUtilities::received_t received;
+
+        TEST_UTILS_CREATE_NODE_WITH_ENDPOINT(node1, ep1, "ep1", 1);
+        TEST_UTILS_CREATE_NODE_WITH_ENDPOINT(node2, ep2, "ep2", 2);
+
+        ep2.add_package_handler(0, TestUtilities::count_received, &received);
+
+        // NOTE: the rings are kept small, so they wrap around many times
+        iac::SharedMemoryConnectionPackage shared_memory{s_ring_capacity};
+
+        if (!shared_memory.region())
+            return {"failed to set up shared memory region"};
+
+        shared_memory.connect(node1, node2);
+
+        auto poll_all_nodes = [&] {
+            node1.poll(poll_timeout_ms);
+            node2.poll(poll_timeout_ms);
+        };
+
+        auto deadline = std::chrono::steady_clock::now() + 5s;
+
+        while (!node1.endpoint_connected(ep2.id()) || !node2.endpoint_connected(ep1.id())) {
+            if (std::chrono::steady_clock::now() > deadline)
+                return {"nodes did not connect over shared memory"};
+            poll_all_nodes();
+        }
+
+        uint8_t payload[max_payload_size];
+        TestUtilities::fill_payload(payload, max_payload_size);
+
+        for (int i = 0; i < num_packages; ++i) {
+            if (!node1.send(ep1, ep2.id(), 0, payload, TestUtilities::varying_payload_size(i, max_payload_size)))
+                return {"failed to send pkg to ep2"};
+            poll_all_nodes();
+        }
+
+        while (received.count < num_packages) {
+            if (std::chrono::steady_clock::now() > deadline)
+                return {"not all packages arrived"};
+            poll_all_nodes();
+        }
+
+        if (received.corrupt)
+            return {"received corrupt payload"};
+
+        // NOTE: bytes left in the ring when a connection is closed must not be read by the next one
+        uint8_t stale[16]{};
+        auto& writer = shared_memory.end1().route().connection();
+        auto& reader = shared_memory.end2().route().connection();
+
+        if (writer.write(stale, sizeof(stale)) != sizeof(stale) || !writer.flush())
+            return {"failed to write stale bytes"};
+
+        if (reader.peek(stale, sizeof(stale) / 2) != sizeof(stale) / 2)
+            return {"failed to peek stale bytes"};
+
+        if (!reader.close() || reader.available() > 0 || reader.buffered() > 0)
+            return {"closed connection kept stale bytes"};
+
+        return {};
+    };
+
+   private:
+    static constexpr size_t s_ring_capacity = 8192;
+};
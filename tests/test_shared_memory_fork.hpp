@@ -0,0 +1,140 @@
+#pragma once
+
+#include <signal.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+#include <chrono>
+
+#include "ftest/test_logging.hpp"
+#include "iac.hpp"
+#include "test_utilities.hpp"
+
+class TestSharedMemoryFork {
+   public:
+    static TestLogging::test_result_t run() {
+        using namespace std::chrono_literals;
+
+        int echoed = 0;
+
+        iac::SharedMemoryRegion region{s_ring_capacity};
+
+        if (!region)
+            return {"failed to set up shared memory region"};
+
+        const pid_t child = fork();
+
+        if (child < 0)
+            return {"fork failed"};
+
+        // NOTE: the child maps the region from copies of its descriptors, like a process which got them over a unix socket
+        if (child == 0)
+            _exit(run_child(dup(region.memory_fd()), dup(region.event_fd(0)), dup(region.event_fd(1))));
+
+        // NOTE: a child which is still running when the parent gives up is killed, so it can't outlive the test
+        auto stop_child = [&](TestLogging::test_result_t result) {
+            kill(child, SIGKILL);
+            waitpid(child, nullptr, 0);
+            return result;
+        };
+
+        TEST_UTILS_CREATE_NODE_WITH_ENDPOINT(node1, ep1, "ep1", 1);
+
+        ep1.add_package_handler(0, count_handler, &echoed);
+
+        iac::LocalTransportRoutePackage<iac::SharedMemoryConnection> end{&region, 0};
+        node1.add_local_transport_route(end);
+
+        const auto deadline = std::chrono::steady_clock::now() + 5s;
+
+        while (!node1.endpoint_connected(s_child_ep_id)) {
+            if (std::chrono::steady_clock::now() > deadline)
+                return stop_child({"nodes did not connect over forked shared memory"});
+            node1.poll(s_poll_timeout_ms);
+        }
+
+        for (uint32_t i = 0; i < s_num_packages; ++i)
+            if (!node1.send(ep1, s_child_ep_id, 0, (const uint8_t*)&i, sizeof(i)))
+                return stop_child({"failed to send pkg to child"});
+
+        while (echoed < (int)s_num_packages) {
+            if (std::chrono::steady_clock::now() > deadline)
+                return stop_child({"child did not echo all packages"});
+            node1.poll(s_poll_timeout_ms);
+        }
+
+        // NOTE: the child keeps its route up until it was told to stop, so none of its echoes is cut off
+        if (!node1.send(ep1, s_child_ep_id, s_stop_type, nullptr, 0))
+            return stop_child({"failed to send stop to child"});
+
+        int status = 0;
+        pid_t exited = 0;
+
+        while ((exited = waitpid(child, &status, WNOHANG)) == 0) {
+            if (std::chrono::steady_clock::now() > deadline)
+                return stop_child({"child did not stop"});
+            node1.poll(s_poll_timeout_ms);
+        }
+
+        if (exited != child || !WIFEXITED(status) || WEXITSTATUS(status) != 0)
+            return {"child failed"};
+
+        return {};
+    };
+
+   private:
+    static constexpr size_t s_ring_capacity = 8192;
+    static constexpr uint32_t s_num_packages = 100;
+    static constexpr int s_poll_timeout_ms = 10;
+    static constexpr iac::ep_id_t s_child_ep_id = 2;
+    static constexpr iac::package_type_t s_stop_type = 1;
+
+    typedef struct echo {
+        iac::LocalNode* node;
+        iac::LocalEndpoint* ep;
+        uint32_t count;
+        bool stopped;
+    } echo_t;
+
+    // NOTE: runs in the child, which leaves with _exit() and never returns into the test suite
+    static int run_child(int memory_fd, int event_fd1, int event_fd2) {
+        using namespace std::chrono_literals;
+
+        iac::SharedMemoryRegion region{memory_fd, event_fd1, event_fd2};
+
+        if (!region) return 1;
+
+        TEST_UTILS_CREATE_NODE_WITH_ENDPOINT(node2, ep2, "ep2", s_child_ep_id);
+
+        echo_t echo{&node2, &ep2, 0, false};
+        ep2.add_package_handler(0, echo_handler, &echo);
+        ep2.add_package_handler(s_stop_type, stop_handler, &echo);
+
+        iac::LocalTransportRoutePackage<iac::SharedMemoryConnection> end{&region, 1};
+        node2.add_local_transport_route(end);
+
+        const auto deadline = std::chrono::steady_clock::now() + 5s;
+
+        while (!echo.stopped) {
+            if (std::chrono::steady_clock::now() > deadline) return 2;
+            node2.poll(s_poll_timeout_ms);
+        }
+
+        return echo.count == s_num_packages ? 0 : 3;
+    };
+
+    static void echo_handler(const iac::Package& pkg, void* data) {
+        auto* echo = (echo_t*)data;
+
+        echo->node->send(*echo->ep, pkg.from(), 0, pkg.payload(), pkg.payload_size());
+        echo->count++;
+    };
+
+    static void stop_handler(const iac::Package& pkg, void* data) {
+        ((echo_t*)data)->stopped = true;
+    };
+
+    static void count_handler(const iac::Package& pkg, void* counter) {
+        (*(int*)counter)++;
+    };
+};
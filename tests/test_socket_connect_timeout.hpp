@@ -0,0 +1,146 @@
+#pragma once
+
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include <chrono>
+#include <thread>
+#include <vector>
+
+#include "ftest/test_logging.hpp"
+#include "iac.hpp"
+#include "test_utilities.hpp"
+
+class TestSocketConnectTimeout {
+   public:
+    static TestLogging::test_result_t run() {
+        using namespace std::chrono_literals;
+
+        static constexpr int num_attempts = 2;
+        static constexpr uint16_t heartbeat_interval_ms = 100;
+        static constexpr uint16_t assume_dead_after_ms = 300;
+        static constexpr auto step = 5ms;
+
+        int received = 0;
+        int sent = 0;
+
+        // NOTE: a closed port refuses the connect right away, a listener with a full backlog drops it unanswered,
+        //       so the connect stays pending until the route gives up on it
+        descriptors_t descriptors;
+
+        if (!open_unanswered_listener(descriptors.fds))
+            return {"failed to fill the backlog of the listener"};
+
+        TEST_UTILS_CREATE_NODE_WITH_ENDPOINT(node1, ep1, "ep1", 1);
+        TEST_UTILS_CREATE_NODE_WITH_ENDPOINT(node2, ep2, "ep2", 2);
+
+        ep2.add_package_handler(0, pkg_handler, &received);
+
+        TEST_UTILS_CONNECT_NODES_WITH_LOOPBACK(tr, node1, node2);
+
+        iac::LocalTransportRoutePackage<iac::SocketClientConnection> client{"127.0.0.1", s_port};
+        client.route().meta().timings = {heartbeat_interval_ms, assume_dead_after_ms};
+        node1.add_local_transport_route(client);
+
+        auto& route = client.route();
+        const auto deadline = std::chrono::steady_clock::now() + 5s;
+
+        int attempts = 0;
+        uint64_t attempt_ts = 0;
+        auto attempt_start = std::chrono::steady_clock::now();
+
+        // NOTE: every attempt has to stay pending for the dead timeout, before the route closes and starts the next one
+        while (attempts <= num_attempts) {
+            if (std::chrono::steady_clock::now() > deadline)
+                return {"pending connect was not retried"};
+
+            TestUtilities::update_all_nodes(node1, node2);
+
+            const bool connecting = route.state() == iac::LocalTransportRoute::route_state::CONNECTING;
+
+            if (connecting && route.meta().last_open_attempt.ts != attempt_ts) {
+                if (attempts > 0 && std::chrono::steady_clock::now() - attempt_start < std::chrono::milliseconds(assume_dead_after_ms))
+                    return {"pending connect was given up before the dead timeout"};
+
+                attempts++;
+                attempt_ts = route.meta().last_open_attempt.ts;
+                attempt_start = std::chrono::steady_clock::now();
+            } else if (!connecting && route.state() != iac::LocalTransportRoute::route_state::CLOSED &&
+                       route.state() != iac::LocalTransportRoute::route_state::INITIALIZED) {
+                return {"unanswered connect left the connecting state"};
+            }
+
+            // NOTE: the loopback route keeps exchanging packages while the other route waits for its connect
+            if (node1.endpoint_connected(ep2.id())) {
+                if (!node1.send(ep1, ep2.id(), 0, (const uint8_t*)&sent, sizeof(sent)))
+                    return {"failed to send pkg to ep2"};
+                sent++;
+            }
+
+            std::this_thread::sleep_for(step);
+        }
+
+        for (int i = 0; i < s_max_num_drain_updates && received < sent; ++i)
+            TestUtilities::update_all_nodes(node1, node2);
+
+        if (sent < s_min_num_packages || received != sent)
+            return {"connecting route held up the other route"};
+
+        return {};
+    };
+
+   private:
+    static constexpr int s_port = 42350;
+    static constexpr int s_max_num_backlog_connects = 16;
+    static constexpr int s_backlog_connect_timeout_ms = 100;
+    static constexpr int s_min_num_packages = 50;
+    static constexpr int s_max_num_drain_updates = 100;
+
+    // closes the descriptors of the listener and its backlog on every way out of the test
+    typedef struct descriptors {
+        std::vector<int> fds;
+
+        ~descriptors() {
+            for (int fd : fds)
+                ::close(fd);
+        };
+    } descriptors_t;
+
+    // listens on `s_port` without ever accepting, and connects to it until a connect isn't answered anymore
+    static bool open_unanswered_listener(std::vector<int>& fds) {
+        sockaddr_in address{};
+        address.sin_family = AF_INET;
+        address.sin_port = htons(s_port);
+        inet_pton(AF_INET, "127.0.0.1", &address.sin_addr);
+
+        const int listen_fd = socket(AF_INET, SOCK_STREAM, 0);
+        if (listen_fd < 0) return false;
+        fds.push_back(listen_fd);
+
+        int opt = 1;
+        if (setsockopt(listen_fd, SOL_SOCKET, SO_REUSEADDR, &opt, sizeof(opt)) < 0 ||
+            bind(listen_fd, (sockaddr*)&address, sizeof(address)) < 0 || listen(listen_fd, 0) < 0)
+            return false;
+
+        for (int i = 0; i < s_max_num_backlog_connects; ++i) {
+            const int fd = socket(AF_INET, SOCK_STREAM | SOCK_NONBLOCK, 0);
+            if (fd < 0) return false;
+            fds.push_back(fd);
+
+            if (connect(fd, (sockaddr*)&address, sizeof(address)) == 0) continue;
+            if (errno != EINPROGRESS) return false;
+
+            pollfd poll_fd{fd, POLLOUT, 0};
+            if (::poll(&poll_fd, 1, s_backlog_connect_timeout_ms) == 0) return true;
+        }
+
+        return false;
+    };
+
+    static void pkg_handler(const iac::Package& pkg, void* counter) {
+        (*(int*)counter)++;
+    };
+};
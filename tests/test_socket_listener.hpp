@@ -0,0 +1,89 @@
+#pragma once
+
+#include <chrono>
+
+#include "ftest/test_logging.hpp"
+#include "iac.hpp"
+#include "test_utilities.hpp"
+
+class TestSocketListener {
+   public:
+    static TestLogging::test_result_t run() {
+        using namespace std::chrono_literals;
+
+        static constexpr int num_packages = 20;
+
+        int rec_pkg_count = 0;
+        int relayed_pkg_count = 0;
+
+        TEST_UTILS_CREATE_NODE_WITH_ENDPOINT(hub, ep1, "ep1", 1);
+        TEST_UTILS_CREATE_NODE_WITH_ENDPOINT(node2, ep2, "ep2", 2);
+        TEST_UTILS_CREATE_NODE_WITH_ENDPOINT(node3, ep3, "ep3", 3);
+        TEST_UTILS_CREATE_NODE_WITH_ENDPOINT(node4, ep4, "ep4", 4);
+
+        ep1.add_package_handler(0, pkg_handler, &rec_pkg_count);
+        ep4.add_package_handler(0, pkg_handler, &relayed_pkg_count);
+
+        iac::SocketListener listener{"127.0.0.1", s_port, iac::SocketConnection::read_mode::BUFFERED};
+
+        if (!listener)
+            return {"failed to set up listening socket"};
+
+        hub.add_connection_listener(listener);
+
+        iac::LocalTransportRoutePackage<iac::SocketClientConnection> client2{"127.0.0.1", s_port};
+        iac::LocalTransportRoutePackage<iac::SocketClientConnection> client3{"127.0.0.1", s_port};
+        iac::LocalTransportRoutePackage<iac::SocketClientConnection> client4{"127.0.0.1", s_port};
+
+        node2.add_local_transport_route(client2);
+        node3.add_local_transport_route(client3);
+        node4.add_local_transport_route(client4);
+
+        auto deadline = std::chrono::steady_clock::now() + 5s;
+
+        while (!hub.endpoints_connected({ep2.id(), ep3.id(), ep4.id()}) || !node2.endpoint_connected(ep4.id())) {
+            if (std::chrono::steady_clock::now() > deadline)
+                return {"clients did not connect to the listener"};
+            TestUtilities::update_all_nodes(hub, node2, node3, node4);
+        }
+
+        if (hub.network().route_mapping().size() < 3)
+            return {"hub did not create a route per client"};
+
+        for (int i = 0; i < num_packages; ++i) {
+            if (!node2.send(ep2, ep1.id(), 0, (const uint8_t*)&i, sizeof(i)) ||
+                !node3.send(ep3, ep1.id(), 0, (const uint8_t*)&i, sizeof(i)))
+                return {"failed to send pkg to ep1"};
+
+            if (!node2.send(ep2, ep4.id(), 0, (const uint8_t*)&i, sizeof(i)))
+                return {"failed to send pkg to ep4"};
+        }
+
+        while (rec_pkg_count < 2 * num_packages || relayed_pkg_count < num_packages) {
+            if (std::chrono::steady_clock::now() > deadline)
+                return {"not all packages arrived"};
+            TestUtilities::update_all_nodes(hub, node2, node3, node4);
+        }
+
+        // NOTE: the accepted route has to be torn down by the hub once the client leaves
+        node3.remove_local_transport_route(client3.route());
+
+        while (hub.endpoint_connected(ep3.id())) {
+            if (std::chrono::steady_clock::now() > deadline)
+                return {"hub did not remove route of closed client"};
+            TestUtilities::update_all_nodes(hub, node2, node4);
+        }
+
+        if (!hub.endpoints_connected({ep2.id(), ep4.id()}))
+            return {"hub lost remaining clients"};
+
+        return {};
+    };
+
+   private:
+    static constexpr int s_port = 42347;
+
+    static void pkg_handler(const iac::Package& pkg, void* counter) {
+        (*(int*)counter)++;
+    };
+};
@@ -0,0 +1,118 @@
+#pragma once
+
+#include <chrono>
+#include <thread>
+
+#include "ftest/test_logging.hpp"
+#include "iac.hpp"
+#include "test_utilities.hpp"
+
+class TestSocketPoll {
+   public:
+    static TestLogging::test_result_t run() {
+        using namespace std::chrono_literals;
+
+        static constexpr int num_packages = 50;
+        static constexpr int poll_timeout_ms = 10;
+        static constexpr int idle_poll_timeout_ms = 200;
+        static constexpr int wake_up_delay_ms = 50;
+
+        int rec_pkg_count = 0;
+
+        TEST_UTILS_CREATE_NODE_WITH_ENDPOINT(node1, ep1, "ep1", 1);
+        TEST_UTILS_CREATE_NODE_WITH_ENDPOINT(node2, ep2, "ep2", 2);
+
+        ep2.add_package_handler(0, pkg_handler, &rec_pkg_count);
+
+        iac::LocalTransportRoutePackage<iac::SocketServerConnection> server{"127.0.0.1", s_port};
+        iac::LocalTransportRoutePackage<iac::SocketClientConnection> client{"127.0.0.1", s_port};
+
+        if (!server.connection())
+            return {"failed to set up server socket"};
+
+        // NOTE: timeouts far beyond the test, so no heartbeat wakes up an idle poll() and a closed connection has to be
+        //       reported by poll()
+        server.route().meta().timings = {5000, 20000};
+        client.route().meta().timings = {5000, 20000};
+
+        node1.add_local_transport_route(server);
+        node2.add_local_transport_route(client);
+
+        auto poll_all_nodes = [&] {
+            node1.poll(poll_timeout_ms);
+            node2.poll(poll_timeout_ms);
+        };
+
+        auto deadline = std::chrono::steady_clock::now() + 5s;
+
+        while (!node1.endpoint_connected(ep2.id()) || !node2.endpoint_connected(ep1.id())) {
+            if (std::chrono::steady_clock::now() > deadline)
+                return {"nodes did not connect over socket"};
+            poll_all_nodes();
+        }
+
+        for (int i = 0; i < num_packages; ++i)
+            if (!node1.send(ep1, ep2.id(), 0, (const uint8_t*)&i, sizeof(i)))
+                return {"failed to send pkg to ep2"};
+
+        while (rec_pkg_count < num_packages) {
+            if (std::chrono::steady_clock::now() > deadline)
+                return {"not all packages arrived"};
+            poll_all_nodes();
+        }
+
+        // NOTE: whatever the last packages left to do is done without waiting
+        node1.poll(0);
+        node2.poll(0);
+
+        auto poll_start = std::chrono::steady_clock::now();
+        node2.poll(idle_poll_timeout_ms);
+        auto poll_duration = std::chrono::steady_clock::now() - poll_start;
+
+        if (poll_duration < std::chrono::milliseconds(idle_poll_timeout_ms * 9 / 10))
+            return {"idle poll returned before its timeout"};
+
+        if (poll_duration > std::chrono::milliseconds(idle_poll_timeout_ms * 2))
+            return {"idle poll overslept its timeout"};
+
+        // NOTE: node1 sends from another thread while node2 sleeps in poll(), which has to return as soon as the data arrives
+        const int received_before_wake_up = rec_pkg_count;
+
+        std::thread sender([&] {
+            std::this_thread::sleep_for(std::chrono::milliseconds(wake_up_delay_ms));
+            const int i = num_packages;
+            node1.send(ep1, ep2.id(), 0, (const uint8_t*)&i, sizeof(i));
+        });
+
+        poll_start = std::chrono::steady_clock::now();
+        node2.poll(idle_poll_timeout_ms * 5);
+        poll_duration = std::chrono::steady_clock::now() - poll_start;
+
+        sender.join();
+
+        if (poll_duration > std::chrono::milliseconds(idle_poll_timeout_ms * 2))
+            return {"poll did not wake up when data arrived"};
+
+        if (rec_pkg_count == received_before_wake_up)
+            return {"package which woke up poll was not handled"};
+
+        node2.remove_local_transport_route(client.route());
+
+        const auto hang_up_deadline = std::chrono::steady_clock::now() + 1s;
+
+        while (node1.all_routes_connected()) {
+            if (std::chrono::steady_clock::now() > hang_up_deadline)
+                return {"closed connection was not noticed"};
+            node1.poll(poll_timeout_ms);
+        }
+
+        return {};
+    };
+
+   private:
+    static constexpr int s_port = 42346;
+
+    static void pkg_handler(const iac::Package& pkg, void* counter) {
+        (*(int*)counter)++;
+    };
+};
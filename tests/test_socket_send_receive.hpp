@@ -0,0 +1,64 @@
+#pragma once
+
+#include <chrono>
+
+#include "ftest/test_logging.hpp"
+#include "iac.hpp"
+#include "test_utilities.hpp"
+
+class TestSocketSendReceive {
+   public:
+    static TestLogging::test_result_t run() {
+        using namespace std::chrono_literals;
+
+        static constexpr int num_packages = 200;
+        static constexpr size_t max_payload_size = 1500;
+
+        TestUtilities::received_t received;
+
+        TEST_UTILS_CREATE_NODE_WITH_ENDPOINT(node1, ep1, "ep1", 1);
+        TEST_UTILS_CREATE_NODE_WITH_ENDPOINT(node2, ep2, "ep2", 2);
+
+        ep2.add_package_handler(0, TestUtilities::count_received, &received);
+
+        iac::LocalTransportRoutePackage<iac::SocketServerConnection> server{"127.0.0.1", s_port, iac::SocketConnection::read_mode::BUFFERED};
+        iac::LocalTransportRoutePackage<iac::SocketClientConnection> client{"127.0.0.1", s_port, iac::SocketConnection::read_mode::BUFFERED};
+
+        if (!server.connection())
+            return {"failed to set up server socket"};
+
+        node1.add_local_transport_route(server);
+        node2.add_local_transport_route(client);
+
+        auto deadline = std::chrono::steady_clock::now() + 5s;
+
+        while (!node1.endpoint_connected(ep2.id()) || !node2.endpoint_connected(ep1.id())) {
+            if (std::chrono::steady_clock::now() > deadline)
+                return {"nodes did not connect over socket"};
+            TestUtilities::update_all_nodes(node1, node2);
+        }
+
+        uint8_t payload[max_payload_size];
+        TestUtilities::fill_payload(payload, max_payload_size);
+
+        for (int i = 0; i < num_packages; ++i) {
+            if (!node1.send(ep1, ep2.id(), 0, payload, TestUtilities::varying_payload_size(i, max_payload_size)))
+                return {"failed to send pkg to ep2"};
+            TestUtilities::update_all_nodes(node1, node2);
+        }
+
+        while (received.count < num_packages) {
+            if (std::chrono::steady_clock::now() > deadline)
+                return {"not all packages arrived"};
+            TestUtilities::update_all_nodes(node1, node2);
+        }
+
+        if (received.corrupt)
+            return {"received corrupt payload"};
+
+        return {};
+    };
+
+   private:
+    static constexpr int s_port = 42345;
+};
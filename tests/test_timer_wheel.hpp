@@ -0,0 +1,35 @@
+#pragma once
+
+#include "ftest/test_logging.hpp"
+#include "iac.hpp"
+
+class TestTimerWheel {
+   public:
+    static TestLogging::test_result_t run() {
+        static constexpr size_t num_timers = 200;
+        static constexpr size_t start = 1000000;
+
+        iac::TimerWheel wheel;
+        iac::TimerWheel::Timer timers[num_timers];
+
+        wheel.advance(start);
+
+        // NOTE: deadlines spread over several turns of the wheel, some of them already passed
+        for (size_t i = 0; i < num_timers; ++i)
+            wheel.schedule(timers[i], start - 50 + i * 37);
+
+        // NOTE: irregular steps, so some ticks are skipped and some are visited several times
+        for (size_t now = start; now < start + num_timers * 37; now += 1 + now % 23) {
+            wheel.advance(now);
+
+            for (size_t i = 0; i < num_timers; ++i)
+                if (timers[i].scheduled() != (now < start - 50 + i * 37)) return {"timer expired at wrong time"};
+        }
+
+        wheel.schedule(timers[0], start + num_timers * 37 + 100);
+        wheel.cancel(timers[0]);
+        if (timers[0].scheduled()) return {"cancelled timer is still scheduled"};
+
+        return {};
+    };
+};
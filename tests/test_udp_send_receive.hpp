@@ -0,0 +1,129 @@
+#pragma once
+
+#include <chrono>
+
+#include "ftest/test_logging.hpp"
+#include "iac.hpp"
+#include "test_utilities.hpp"
+
+class TestUdpSendReceive {
+   public:
+    static TestLogging::test_result_t run() {
+        using namespace std::chrono_literals;
+
+        static constexpr int num_packages = 200;
+        static constexpr size_t max_payload_size = 1500;
+
+        TestUtilities::received_t received;
+
+        TEST_UTILS_CREATE_NODE_WITH_ENDPOINT(node1, ep1, "ep1", 1);
+        TEST_UTILS_CREATE_NODE_WITH_ENDPOINT(node2, ep2, "ep2", 2);
+
+        ep2.add_package_handler(0, TestUtilities::count_received, &received);
+
+        iac::LocalTransportRoutePackage<iac::UdpConnection> udp1{"127.0.0.1", s_port1, "127.0.0.1", s_port2};
+        iac::LocalTransportRoutePackage<iac::UdpConnection> udp2{"127.0.0.1", s_port2, "127.0.0.1", s_port1};
+
+        node1.add_local_transport_route(udp1);
+        node2.add_local_transport_route(udp2);
+
+        auto deadline = std::chrono::steady_clock::now() + 5s;
+
+        while (!node1.endpoint_connected(ep2.id()) || !node2.endpoint_connected(ep1.id())) {
+            if (std::chrono::steady_clock::now() > deadline)
+                return {"nodes did not connect over udp"};
+            TestUtilities::update_all_nodes(node1, node2);
+        }
+
+        uint8_t payload[max_payload_size];
+        TestUtilities::fill_payload(payload, max_payload_size);
+
+        for (int i = 0; i < num_packages; ++i) {
+            if (!node1.send(ep1, ep2.id(), 0, payload, TestUtilities::varying_payload_size(i, max_payload_size)))
+                return {"failed to send pkg to ep2"};
+            TestUtilities::update_all_nodes(node1, node2);
+        }
+
+        // NOTE: the loopback interface does not drop datagrams at this rate, so every package has to arrive
+        while (received.count < num_packages) {
+            if (std::chrono::steady_clock::now() > deadline)
+                return {"not all packages arrived"};
+            TestUtilities::update_all_nodes(node1, node2);
+        }
+
+        if (received.corrupt)
+            return {"received corrupt payload"};
+
+        // NOTE: datagrams written past the route, one claims a frame larger than itself and one starts with garbage
+        //       followed by a start byte, neither may take the datagrams after them along when they are dropped
+        static constexpr uint8_t start_byte = 0b10101010;
+        static constexpr uint16_t claimed_size = 1000;
+
+        uint8_t oversized[8]{start_byte};
+        memcpy(oversized + 1, &claimed_size, sizeof(claimed_size));
+
+        uint8_t garbage[8]{1, 2, start_byte, 16};
+
+        auto& connection = udp1.route().connection();
+        if (connection.write(oversized, sizeof(oversized)) != sizeof(oversized) || connection.write(garbage, sizeof(garbage)) != sizeof(garbage))
+            return {"failed to write corrupt datagrams"};
+
+        for (int i = 0; i < num_packages_after_corruption; ++i)
+            if (!node1.send(ep1, ep2.id(), 0, payload, payload_size_after_corruption))
+                return {"failed to send pkg to ep2"};
+
+        while (received.count < num_packages + num_packages_after_corruption) {
+            if (std::chrono::steady_clock::now() > deadline)
+                return {"packages after corrupt datagrams were lost"};
+            TestUtilities::update_all_nodes(node1, node2);
+        }
+
+        if (received.corrupt)
+            return {"received corrupt payload"};
+
+        // NOTE: node2 isn't updated while node1 floods it, so everything beyond the limit has to stay in the kernel
+        uint8_t flood[flood_datagram_size]{};
+
+        for (int i = 0; i < num_flood_datagrams; ++i)
+            if (connection.write(flood, sizeof(flood)) != sizeof(flood))
+                return {"failed to write flood datagrams"};
+
+        if (!connection.flush())
+            return {"failed to flush flood datagrams"};
+
+        auto& flooded = udp2.route().connection();
+
+        for (int i = 0; i < num_flood_prefetches; ++i) {
+            if (!flooded.prefetch())
+                return {"prefetch failed"};
+
+            if (flooded.buffered() > iac::UdpConnection::s_max_buffered_size)
+                return {"prefetch buffered datagrams beyond the limit"};
+        }
+
+        if (flooded.buffered() == 0)
+            return {"prefetch buffered nothing"};
+
+        const int received_before_flood = received.count;
+
+        if (!node1.send(ep1, ep2.id(), 0, payload, payload_size_after_corruption))
+            return {"failed to send pkg to ep2"};
+
+        while (received.count == received_before_flood) {
+            if (std::chrono::steady_clock::now() > deadline)
+                return {"route did not recover from the flood"};
+            TestUtilities::update_all_nodes(node1, node2);
+        }
+
+        return {};
+    };
+
+   private:
+    static constexpr int s_port1 = 42348;
+    static constexpr int s_port2 = 42349;
+    static constexpr int num_packages_after_corruption = 10;
+    static constexpr size_t payload_size_after_corruption = 100;
+    static constexpr size_t flood_datagram_size = 4096;
+    static constexpr int num_flood_datagrams = 64;
+    static constexpr int num_flood_prefetches = 20;
+};
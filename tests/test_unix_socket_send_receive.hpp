@@ -0,0 +1,73 @@
+#pragma once
+
+#include <chrono>
+
+#include "ftest/test_logging.hpp"
+#include "iac.hpp"
+#include "test_utilities.hpp"
+
+class TestUnixSocketSendReceive {
+   public:
+    static TestLogging::test_result_t run() {
+        using namespace std::chrono_literals;
+
+        static constexpr int num_packages = 200;
+        static constexpr size_t max_payload_size = 1500;
+
+        TestUtilities::received_t received;
+
+        TEST_UTILS_CREATE_NODE_WITH_ENDPOINT(node1, ep1, "ep1", 1);
+        TEST_UTILS_CREATE_NODE_WITH_ENDPOINT(node2, ep2, "ep2", 2);
+        TEST_UTILS_CREATE_NODE_WITH_ENDPOINT(node3, ep3, "ep3", 3);
+
+        ep1.add_package_handler(0, TestUtilities::count_received, &received);
+
+        // NOTE: node2 connects over a socket file, node3 over the abstract namespace
+        iac::LocalTransportRoutePackage<iac::UnixSocketServerConnection> server{s_path, iac::SocketConnection::read_mode::BUFFERED};
+        iac::LocalTransportRoutePackage<iac::UnixSocketClientConnection> client2{s_path, iac::SocketConnection::read_mode::BUFFERED};
+
+        iac::UnixSocketListener listener{s_abstract_path};
+        iac::LocalTransportRoutePackage<iac::UnixSocketClientConnection> client3{s_abstract_path};
+
+        if (!server.connection() || !listener)
+            return {"failed to set up unix sockets"};
+
+        node1.add_local_transport_route(server);
+        node1.add_connection_listener(listener);
+        node2.add_local_transport_route(client2);
+        node3.add_local_transport_route(client3);
+
+        auto deadline = std::chrono::steady_clock::now() + 5s;
+
+        while (!node1.endpoints_connected({ep2.id(), ep3.id()}) || !node2.endpoint_connected(ep1.id()) || !node3.endpoint_connected(ep1.id())) {
+            if (std::chrono::steady_clock::now() > deadline)
+                return {"nodes did not connect over unix socket"};
+            TestUtilities::update_all_nodes(node1, node2, node3);
+        }
+
+        uint8_t payload[max_payload_size];
+        TestUtilities::fill_payload(payload, max_payload_size);
+
+        for (int i = 0; i < num_packages; ++i) {
+            if (!node2.send(ep2, ep1.id(), 0, payload, TestUtilities::varying_payload_size(i, max_payload_size)) ||
+                !node3.send(ep3, ep1.id(), 0, payload, TestUtilities::varying_payload_size(i, max_payload_size, 89)))
+                return {"failed to send pkg to ep1"};
+            TestUtilities::update_all_nodes(node1, node2, node3);
+        }
+
+        while (received.count < 2 * num_packages) {
+            if (std::chrono::steady_clock::now() > deadline)
+                return {"not all packages arrived"};
+            TestUtilities::update_all_nodes(node1, node2, node3);
+        }
+
+        if (received.corrupt)
+            return {"received corrupt payload"};
+
+        return {};
+    };
+
+   private:
+    static constexpr const char* s_path = "/tmp/iac-test-unix-socket";
+    static constexpr const char* s_abstract_path = "@iac-test-unix-socket";
+};
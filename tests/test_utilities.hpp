@@ -12,6 +12,27 @@
     iac::LoopbackConnectionPackage<iac::LoopbackConnection> tr_name;            \
     tr_name.connect(node1_name, node2_name)
 
+// takes at most the bytes of its budget, the rest stays queued in the route, unlimited until a budget is set
+class ThrottledLoopbackConnection : public iac::LoopbackConnection {
+   public:
+    using iac::LoopbackConnection::LoopbackConnection;
+
+    size_t write(const void* buffer, size_t size) override {
+        const size_t written_size = iac::LoopbackConnection::write(buffer, iac::min_of(size, m_budget));
+        if (m_budget != unlimited) m_budget -= written_size;
+        return written_size;
+    };
+
+    void set_budget(size_t budget) {
+        m_budget = budget;
+    };
+
+   private:
+    static constexpr size_t unlimited = iac::numeric_limits<size_t>::max();
+
+    size_t m_budget = unlimited;
+};
+
 class TestUtilities {
    private:
     static bool all_nodes_connected() {
@@ -21,12 +42,53 @@ class TestUtilities {
     static void update_all_nodes(){};
 
    public:
-    template <typename F, typename... Args>
-    static void update_til_connected(F after_update, iac::LocalNode& node, Args&... nodes) {
-        while (!all_nodes_connected(node, nodes...)) {
+    // NOTE: far more updates than any of the tests needs, so a wait which never ends fails instead of hanging
+    static constexpr int s_max_num_updates = 100000;
+
+    // counts the packages it handles, and whether any payload differed from the one `fill_payload` writes
+    typedef struct received {
+        int count = 0;
+        bool corrupt = false;
+    } received_t;
+
+    // updates the nodes until `condition` holds, false if it still doesn't after `s_max_num_updates` updates
+    template <typename C, typename F, typename... Args>
+    static bool update_until(C condition, F after_update, iac::LocalNode& node, Args&... nodes) {
+        for (int i = 0; !condition(); ++i) {
+            if (i == s_max_num_updates) return false;
+
             update_all_nodes(node, nodes...);
             after_update();
         }
+        return true;
+    };
+
+    template <typename F, typename... Args>
+    static bool update_til_connected(F after_update, iac::LocalNode& node, Args&... nodes) {
+        return update_until([&] { return all_nodes_connected(node, nodes...); }, after_update, node, nodes...);
+    };
+
+    static void fill_payload(uint8_t* payload, size_t size) {
+        for (size_t i = 0; i < size; ++i)
+            payload[i] = i;
+    };
+
+    static bool payload_intact(const uint8_t* payload, size_t size) {
+        for (size_t i = 0; i < size; ++i)
+            if (payload[i] != (uint8_t)i) return false;
+        return true;
+    };
+
+    // spreads the sizes of consecutive packages over [0, max_size), so frames end at ever changing offsets
+    static size_t varying_payload_size(int index, size_t max_size, size_t step = 97) {
+        return (index * step) % max_size;
+    };
+
+    static void count_received(const iac::Package& pkg, void* data) {
+        auto* received = (received_t*)data;
+
+        if (!payload_intact(pkg.payload(), pkg.payload_size())) received->corrupt = true;
+        received->count++;
     };
 
     template <typename... Args>
@@ -0,0 +1,63 @@
+#pragma once
+
+#include "ftest/test_logging.hpp"
+#include "iac.hpp"
+#include "test_utilities.hpp"
+
+class TestVirtualClock {
+   public:
+    static TestLogging::test_result_t run() {
+        static constexpr uint16_t assume_dead_after_ms = 500;
+        static constexpr uint64_t step_ms = 10;
+
+        iac::VirtualClock clock;
+
+        iac::LocalNode node1{{100, assume_dead_after_ms}};
+        iac::LocalNode node2{{100, assume_dead_after_ms}};
+        iac::LocalEndpoint ep1{1, "ep1"};
+        iac::LocalEndpoint ep2{2, "ep2"};
+
+        node1.add_local_endpoint(ep1);
+        node2.add_local_endpoint(ep2);
+        node1.set_clock(&clock);
+        node2.set_clock(&clock);
+
+        iac::LoopbackConnectionPackage<iac::LoopbackConnection> tr1;
+        tr1.end1().route().meta().timings = {100, assume_dead_after_ms};
+        tr1.end2().route().meta().timings = {100, assume_dead_after_ms};
+        tr1.connect(node1, node2);
+
+        if (!TestUtilities::update_until([&] { return node1.endpoint_connected(ep2.id()) && node2.endpoint_connected(ep1.id()); }, [] {}, node1, node2))
+            return {"nodes did not connect"};
+
+        // NOTE: heartbeats keep the route alive for as long as both sides are updated
+        for (uint64_t elapsed_ms = 0; elapsed_ms < 10 * assume_dead_after_ms; elapsed_ms += step_ms) {
+            TestUtilities::update_all_nodes(node1, node2);
+            clock.advance_ms(step_ms);
+        }
+
+        if (!TestUtilities::all_nodes_connected(node1, node2))
+            return {"route timed out although heartbeats were sent"};
+
+        // NOTE: once node2 stops, node1 has to give up on it after exactly the same virtual time in every run
+        uint64_t elapsed_ms = 0;
+        while (node1.all_routes_connected()) {
+            if (elapsed_ms > 2 * assume_dead_after_ms)
+                return {"silent route did not time out"};
+
+            node1.update();
+            clock.advance_ms(step_ms);
+            elapsed_ms += step_ms;
+        }
+
+        if (elapsed_ms < assume_dead_after_ms - 100)
+            return {"route timed out too early"};
+
+        TestLogging::test_printf("route timed out after %d ms of virtual time", (int)elapsed_ms);
+
+        if (!TestUtilities::update_til_connected([&clock] { clock.advance_ms(step_ms); }, node1, node2))
+            return {"route did not reconnect"};
+
+        return {};
+    };
+};
@@ -1,14 +1,53 @@
 #include "ftest/test_logging.hpp"
 #include "iac.hpp"
 #include "logging.hpp"
+#include "test_batch_framing.hpp"
+#include "test_concurrent_loopback.hpp"
+#include "test_cut_through.hpp"
 #include "test_disconnect_reconnect.hpp"
+#include "test_bidirectional_relay.hpp"
+#include "test_flow_control.hpp"
+#include "test_flow_control_bulk.hpp"
+#include "test_fragment_loss.hpp"
+#include "test_fragmentation.hpp"
+#include "test_handshake_order.hpp"
+#include "test_id_map.hpp"
+#include "test_lossy_handshake.hpp"
 #include "test_network_building.hpp"
+#include "test_next_hop_cache.hpp"
+#include "test_outbound_queue.hpp"
+#include "test_output_coalescing.hpp"
+#include "test_package_handlers.hpp"
+#include "test_payload_view.hpp"
+#include "test_priority_classes.hpp"
+#include "test_reliable_delivery.hpp"
+#include "test_reliable_restart.hpp"
+#include "test_ring_buffer.hpp"
 #include "test_send_receive.hpp"
+#include "test_socket_connect_timeout.hpp"
+#include "test_socket_listener.hpp"
+#include "test_socket_send_receive.hpp"
+#include "test_timer_wheel.hpp"
+#include "test_unix_socket_send_receive.hpp"
+#include "test_virtual_clock.hpp"
 
 #ifndef IAC_DISABLE_VISUALIZATION
 #    include "test_network_visualization.hpp"
 #endif
 
+#ifdef IAC_HAS_EPOLL
+#    include "test_socket_poll.hpp"
+#endif
+
+#ifdef IAC_HAS_SHARED_MEMORY
+#    include "test_shared_memory.hpp"
+#    include "test_shared_memory_fork.hpp"
+#endif
+
+#ifdef IAC_HAS_UDP
+#    include "test_udp_send_receive.hpp"
+#endif
+
 int main(int argc, char* argv[]) {
     iac::Logging::set_loglevel(iac::Logging::loglevels::debug);
 
@@ -21,9 +60,48 @@ int main(int argc, char* argv[]) {
 
     TestLogging::start_suite("communication");
 
+    TestLogging::run("ring-buffer", TestRingBuffer::run);
+    TestLogging::run("id-map", TestIdMap::run);
+    TestLogging::run("timer-wheel", TestTimerWheel::run);
     TestLogging::run("disconnect-reconnect", TestDisconnectReconnect::run);
+    TestLogging::run("handshake-order", TestHandshakeOrder::run);
+    TestLogging::run("lossy-handshake", TestLossyHandshake::run);
+    TestLogging::run("virtual-clock", TestVirtualClock::run);
     TestLogging::run("send-receive", TestSendReceive::run);
     TestLogging::run("network-building", TestNetworkBuilding::run);
+    TestLogging::run("payload-view", TestPayloadView::run);
+    TestLogging::run("package-handlers", TestPackageHandlers::run);
+    TestLogging::run("concurrent-loopback", TestConcurrentLoopback::run);
+    TestLogging::run("socket-send-receive", TestSocketSendReceive::run);
+    TestLogging::run("socket-listener", TestSocketListener::run);
+    TestLogging::run("socket-connect-timeout", TestSocketConnectTimeout::run);
+    TestLogging::run("unix-socket-send-receive", TestUnixSocketSendReceive::run);
+    TestLogging::run("outbound-queue", TestOutboundQueue::run);
+    TestLogging::run("output-coalescing", TestOutputCoalescing::run);
+    TestLogging::run("batch-framing", TestBatchFraming::run);
+    TestLogging::run("fragmentation", TestFragmentation::run);
+    TestLogging::run("fragment-loss", TestFragmentLoss::run);
+    TestLogging::run("cut-through", TestCutThrough::run);
+    TestLogging::run("next-hop-cache", TestNextHopCache::run);
+    TestLogging::run("reliable-delivery", TestReliableDelivery::run);
+    TestLogging::run("reliable-restart", TestReliableRestart::run);
+    TestLogging::run("flow-control", TestFlowControl::run);
+    TestLogging::run("flow-control-bulk", TestFlowControlBulk::run);
+    TestLogging::run("bidirectional-relay", TestBidirectionalRelay::run);
+    TestLogging::run("priority-classes", TestPriorityClasses::run);
+
+#ifdef IAC_HAS_EPOLL
+    TestLogging::run("socket-poll", TestSocketPoll::run);
+#endif
+
+#ifdef IAC_HAS_SHARED_MEMORY
+    TestLogging::run("shared-memory", TestSharedMemory::run);
+    TestLogging::run("shared-memory-fork", TestSharedMemoryFork::run);
+#endif
+
+#ifdef IAC_HAS_UDP
+    TestLogging::run("udp-send-receive", TestUdpSendReceive::run);
+#endif
 
     return TestLogging::results();
 }
\ No newline at end of file